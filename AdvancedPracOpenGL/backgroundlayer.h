@@ -0,0 +1,47 @@
+#pragma once
+#include "GL/glut.h"
+
+/* BackgroundLayer: static drawing of a view cached in a display list
+*  The drawing is recorded once and replayed every frame until it is
+*  invalidated or the window size it was recorded for changes. It is
+*  replayed without writing depth, so everything drawn after it in
+*  the frame is composited over it.
+*/
+class BackgroundLayer {
+public:
+	// Mark the recorded drawing stale, so the next draw records it again
+	void invalidate() { valid = false; }
+
+	/*
+	* draw
+	* Replay the recorded drawing, recording it first if it is stale.
+	*
+	* @param	width, height	window size the drawing depends on
+	*			record			draws the layer with immediate GL calls
+	*/
+	template <typename Record>
+	void draw(int width, int height, Record record)
+	{
+		if (!valid || width != recordedWidth || height != recordedHeight)
+		{
+			if (list == 0) list = glGenLists(1);
+			glNewList(list, GL_COMPILE);
+			record();
+			glEndList();
+			recordedWidth = width;
+			recordedHeight = height;
+			valid = true;
+		}
+
+		glPushAttrib(GL_DEPTH_BUFFER_BIT);
+		glDepthMask(GL_FALSE);
+		glCallList(list);
+		glPopAttrib();
+	}
+
+private:
+	GLuint list = 0;			// display list holding the drawing
+	bool valid = false;			// the display list matches the current settings
+	int recordedWidth = 0;		// window width when recorded
+	int recordedHeight = 0;		// window height when recorded
+};
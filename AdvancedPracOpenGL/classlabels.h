@@ -0,0 +1,211 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include <algorithm>
+
+// Compact class id of a data point
+typedef std::uint16_t ClassLabel;
+
+/* ClassDictionary: mapping between class names and class ids
+*  Ids are assigned densely in order of first appearance, so
+*  they can index per-class arrays directly.
+*/
+class ClassDictionary {
+public:
+	// Get the id of a class name, adding the class if it is new
+	ClassLabel intern(const std::string& name)
+	{
+		auto found = ids.find(name);
+		if (found != ids.end()) return found->second;
+
+		ClassLabel label = (ClassLabel)names.size();
+		ids[name] = label;
+		names.push_back(name);
+		return label;
+	}
+
+	// Get the id of a class name, or the number of classes if it has none
+	ClassLabel find(const std::string& name) const
+	{
+		auto found = ids.find(name);
+		return (found != ids.end()) ? found->second : (ClassLabel)names.size();
+	}
+
+	// Get the name of a class id
+	const std::string& name(ClassLabel label) const { return names[label]; }
+
+	// Number of classes
+	std::size_t size() const { return names.size(); }
+
+private:
+	std::vector<std::string> names{};						// name of each class id
+	std::unordered_map<std::string, ClassLabel> ids{};		// id of each class name
+};
+
+/* ClassHistogram: count of rows per class
+*  Used for the class composition and purity of clusters
+*  and hyperblocks with any number of classes.
+*/
+class ClassHistogram {
+public:
+	// Constructor
+	ClassHistogram(std::size_t numClasses = 0) : counts(numClasses, 0) {}
+
+	// Count a row of the given class
+	void add(ClassLabel label, unsigned int count = 1)
+	{
+		if (label >= counts.size()) counts.resize(label + 1, 0);
+		counts[label] += count;
+		total += count;
+	}
+
+	// Reset every count to zero
+	void clear()
+	{
+		std::fill(counts.begin(), counts.end(), 0);
+		total = 0;
+	}
+
+	// Number of rows of a class
+	unsigned int count(ClassLabel label) const { return (label < counts.size()) ? counts[label] : 0; }
+
+	// Number of rows of every class
+	unsigned int getTotal() const { return total; }
+
+	// Class with the most rows (lowest id on ties)
+	ClassLabel dominant() const
+	{
+		ClassLabel best = 0;
+		for (std::size_t label = 1; label < counts.size(); ++label)
+		{
+			if (counts[label] > counts[best]) best = (ClassLabel)label;
+		}
+		return best;
+	}
+
+	// Fraction of rows belonging to the dominant class
+	float purity() const { return (total > 0) ? (float)count(dominant()) / total : 0.0f; }
+
+private:
+	std::vector<unsigned int> counts{};		// rows per class id
+	unsigned int total = 0;					// rows of every class
+};
+
+/* LabelColumn: class label of every row of a data set
+*  Stores one 16-bit class id per row along with the class
+*  dictionary.
+*/
+class LabelColumn {
+public:
+	// Register a class name without labelling a row, returning its id
+	ClassLabel addClass(const std::string& name) { return dictionary.intern(name); }
+
+	// Append a row of the named class
+	void push_back(const std::string& name) { push_back(addClass(name)); }
+
+	// Append a row of a registered class id
+	void push_back(ClassLabel label) { labels.push_back(label); }
+
+	// Class id of a row
+	ClassLabel operator[](std::size_t row) const { return labels[row]; }
+
+	// Number of labelled rows
+	std::size_t size() const { return labels.size(); }
+
+	// Number of classes
+	std::size_t numClasses() const { return dictionary.size(); }
+
+	// Name of a class id
+	const std::string& name(ClassLabel label) const { return dictionary.name(label); }
+
+	// Id of a class name, or numClasses() if no row has it
+	ClassLabel find(const std::string& name) const { return dictionary.find(name); }
+
+	// Get the class id of every row
+	const std::vector<ClassLabel>& getLabels() const { return labels; }
+
+	std::vector<ClassLabel>::const_iterator begin() const { return labels.begin(); }
+	std::vector<ClassLabel>::const_iterator end() const { return labels.end(); }
+
+private:
+	std::vector<ClassLabel> labels{};		// class id of each row
+	ClassDictionary dictionary{};			// class names
+};
+
+/* RowCounts: class multiplicities of each row of a data set
+*  A row may stand for several identical data points, possibly of
+*  different classes. Each row keeps a count per class, and its
+*  weight is the total number of data points it represents.
+*/
+class RowCounts {
+public:
+	// Constructor
+	RowCounts(std::size_t numClasses = 0) : numClasses(numClasses) {}
+
+	// Constructor: one data point per row, of the row's class
+	RowCounts(const LabelColumn& classify) : numClasses(classify.numClasses())
+	{
+		for (std::size_t row = 0; row < classify.size(); ++row)
+		{
+			addRow();
+			add(row, classify[row]);
+		}
+	}
+
+	// Append a row with no data points
+	void addRow()
+	{
+		counts.resize(counts.size() + numClasses, 0);
+		weights.push_back(0);
+	}
+
+	// Count data points of a class in a row
+	void add(std::size_t row, ClassLabel label, unsigned int count = 1)
+	{
+		counts[row * numClasses + label] += count;
+		weights[row] += count;
+	}
+
+	// Number of data points of a class in a row
+	unsigned int count(std::size_t row, ClassLabel label) const { return counts[row * numClasses + label]; }
+
+	// Number of data points in a row
+	unsigned int weight(std::size_t row) const { return weights[row]; }
+
+	// Get the weight of every row
+	const std::vector<unsigned int>& getWeights() const { return weights; }
+
+	// Add the class counts of a row to a histogram
+	void addTo(std::size_t row, ClassHistogram* histogram) const
+	{
+		for (std::size_t label = 0; label < numClasses; ++label)
+		{
+			unsigned int count = counts[row * numClasses + label];
+			if (count > 0) histogram->add((ClassLabel)label, count);
+		}
+	}
+
+	// Class with the most data points in a row (lowest id on ties)
+	ClassLabel dominant(std::size_t row) const
+	{
+		ClassLabel best = 0;
+		for (std::size_t label = 1; label < numClasses; ++label)
+		{
+			if (count(row, (ClassLabel)label) > count(row, best)) best = (ClassLabel)label;
+		}
+		return best;
+	}
+
+	// Number of rows
+	std::size_t size() const { return weights.size(); }
+
+	// Number of classes
+	std::size_t getNumClasses() const { return numClasses; }
+
+private:
+	std::size_t numClasses;					// classes counted per row
+	std::vector<unsigned int> counts{};		// data points per row and class
+	std::vector<unsigned int> weights{};	// data points per row
+};
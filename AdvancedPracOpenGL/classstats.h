@@ -0,0 +1,326 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "GL/glut.h"
+#include "dataview.h"
+#include "parallel.h"
+#include "classlabels.h"
+
+/* ColumnarData: column-major copy of a data set
+*  Attribute d of row r is stored at values[d * numRows + r], so
+*  per-attribute passes read contiguous memory. The range of every
+*  column is recorded while the columns are filled.
+*/
+struct ColumnarData {
+	std::size_t numRows = 0;				// number of rows
+	std::size_t numDims = 0;				// number of attributes per row
+	std::vector<GLfloat> values{};			// column-major attribute values
+	std::vector<GLfloat> columnMin{};		// minimum of each column
+	std::vector<GLfloat> columnMax{};		// maximum of each column
+
+	/*
+	* fromView
+	* Transpose the selected rows of a data set into columns.
+	*
+	* @param	data	view of the rows to store
+	*			dims	number of attributes to keep per row
+	* @return	ColumnarData	columns of the selected rows
+	*/
+	static ColumnarData fromView(const DataView& data, std::size_t dims)
+	{
+		ColumnarData columns;
+		columns.numRows = data.size();
+		columns.numDims = dims;
+		columns.values.resize(dims * data.size());
+		columns.columnMin.assign(dims, std::numeric_limits<GLfloat>::max());
+		columns.columnMax.assign(dims, std::numeric_limits<GLfloat>::lowest());
+
+		for (std::size_t r = 0; r < data.size(); ++r)
+		{
+			RowView row = data[r];
+			for (std::size_t d = 0; d < dims; ++d)
+			{
+				GLfloat value = row[d];
+				columns.values[d * columns.numRows + r] = value;
+				columns.columnMin[d] = std::min(columns.columnMin[d], value);
+				columns.columnMax[d] = std::max(columns.columnMax[d], value);
+			}
+		}
+		return columns;
+	}
+
+	// Get the values of one attribute
+	const GLfloat* column(std::size_t d) const { return &values[d * numRows]; }
+};
+
+/* QuantileSketch: fixed-range histogram quantile sketch
+*  Values are counted into equal-width bins over a known range.
+*  Sketches over the same range merge by adding bin counts, and
+*  quantiles are interpolated within the bin that holds them.
+*/
+class QuantileSketch {
+public:
+	// Constructor
+	QuantileSketch(GLfloat low = 0.0, GLfloat high = 1.0, unsigned int numBins = 64)
+		: low(low), high(high), bins(numBins, 0) {}
+
+	// Count a value occurring weight times
+	void add(GLfloat value, unsigned int weight = 1)
+	{
+		bins[binOf(value)] += weight;
+		count += weight;
+	}
+
+	// Add the counts of a sketch over the same range
+	void merge(const QuantileSketch& other)
+	{
+		for (std::size_t i = 0; i < bins.size(); ++i) bins[i] += other.bins[i];
+		count += other.count;
+	}
+
+	/*
+	* quantile
+	* Estimate the value below which a fraction q of the counted values lie.
+	*
+	* @param	q	fraction in [0, 1]
+	* @return	estimated quantile value
+	*/
+	GLfloat quantile(GLfloat q) const
+	{
+		if (count == 0) return low;
+
+		double target = q * count;
+		double seen = 0.0;
+		GLfloat width = binWidth();
+		for (std::size_t i = 0; i < bins.size(); ++i)
+		{
+			if (bins[i] > 0 && seen + bins[i] >= target)
+			{
+				double within = (target - seen) / bins[i];
+				return low + width * (GLfloat)(i + within);
+			}
+			seen += bins[i];
+		}
+		return high;
+	}
+
+private:
+
+	GLfloat binWidth() const
+	{
+		GLfloat width = (high - low) / bins.size();
+		return (width > 0.0) ? width : 1.0f;
+	}
+
+	std::size_t binOf(GLfloat value) const
+	{
+		long bin = (long)((value - low) / binWidth());
+		return (std::size_t)std::min<long>(std::max<long>(bin, 0), (long)bins.size() - 1);
+	}
+
+	GLfloat low;							// lower end of the sketched range
+	GLfloat high;							// upper end of the sketched range
+	std::vector<unsigned long long> bins;	// count of values per bin
+	unsigned long long count = 0;			// total values counted
+};
+
+/* AttributeStats: running statistics of one attribute of one class
+*  Mean and variance are accumulated with Welford's method, and
+*  partial results from separate workers are combined with Chan's
+*  parallel update.
+*/
+struct AttributeStats {
+	unsigned long long count = 0;
+	double mean = 0.0;
+	double m2 = 0.0;			// sum of squared differences from the mean
+	GLfloat min = std::numeric_limits<GLfloat>::max();
+	GLfloat max = std::numeric_limits<GLfloat>::lowest();
+	QuantileSketch sketch;
+
+	// Add a value occurring weight times
+	void add(GLfloat value, unsigned int weight = 1)
+	{
+		count += weight;
+		double delta = value - mean;
+		mean += delta * weight / count;
+		m2 += weight * delta * (value - mean);
+		min = std::min(min, value);
+		max = std::max(max, value);
+		sketch.add(value, weight);
+	}
+
+	// Combine with the statistics of another partition
+	void merge(const AttributeStats& other)
+	{
+		if (other.count == 0) return;
+		if (count == 0)
+		{
+			*this = other;
+			return;
+		}
+
+		unsigned long long total = count + other.count;
+		double delta = other.mean - mean;
+		mean += delta * other.count / total;
+		m2 += other.m2 + delta * delta * ((double)count * other.count / total);
+		count = total;
+		min = std::min(min, other.min);
+		max = std::max(max, other.max);
+		sketch.merge(other.sketch);
+	}
+
+	// Sample variance of the values
+	double variance() const { return (count > 1) ? m2 / (count - 1) : 0.0; }
+};
+
+/* ClassStatistics: per-class statistics of every attribute
+*  Computes the count, mean, variance, min, max and a quantile
+*  sketch of each attribute for each class in a single parallel
+*  pass over columnar data, or over the rows of a view in place.
+*  Every worker reduces a contiguous block of rows into its own
+*  accumulators, which are merged at the end.
+*/
+class ClassStatistics {
+public:
+	/*
+	* compute
+	* Gather statistics of every attribute for every class.
+	*
+	* @param	columns		columnar data set
+	*			labels		class id of each row, in [0, numClasses)
+	*			numClasses	number of classes
+	*/
+	void compute(const ColumnarData& columns, const std::vector<ClassLabel>& labels, unsigned int numClasses)
+	{
+		compute(columns, labels, std::vector<unsigned int>(labels.size(), 1), numClasses);
+	}
+
+	/*
+	* compute
+	* Gather statistics of every attribute for every class, counting
+	* each row as weights[r] identical data points.
+	*
+	* @param	columns		columnar data set
+	*			labels		class id of each row, in [0, numClasses)
+	*			weights		number of data points of each row
+	*			numClasses	number of classes
+	*/
+	void compute(const ColumnarData& columns, const std::vector<ClassLabel>& labels,
+		const std::vector<unsigned int>& weights, unsigned int numClasses)
+	{
+		// Column by column, reading contiguous values
+		reduce(columns.numRows, columns.numDims, columns.columnMin, columns.columnMax, labels, weights, numClasses,
+			[&](std::size_t begin, std::size_t end, std::vector<AttributeStats>* local)
+		{
+			for (std::size_t d = 0; d < numDims; ++d)
+			{
+				const GLfloat* column = columns.column(d);
+				for (std::size_t r = begin; r < end; ++r) (*local)[labels[r] * numDims + d].add(column[r], weights[r]);
+			}
+		});
+	}
+
+	/*
+	* compute
+	* Gather statistics of the first dims attributes for every class,
+	* reading the rows of a view in place instead of a columnar copy.
+	*
+	* @param	data		view of the rows
+	*			dims		number of attributes per row
+	*			labels		class id of each row of the view, in [0, numClasses)
+	*			weights		number of data points of each row of the view
+	*			numClasses	number of classes
+	*/
+	void compute(const DataView& data, std::size_t dims, const std::vector<ClassLabel>& labels,
+		const std::vector<unsigned int>& weights, unsigned int numClasses)
+	{
+		// Ranges of the columns, for the sketches
+		std::vector<GLfloat> low(dims, std::numeric_limits<GLfloat>::max());
+		std::vector<GLfloat> high(dims, std::numeric_limits<GLfloat>::lowest());
+		for (std::size_t r = 0; r < data.size(); ++r)
+		{
+			RowView row = data[r];
+			for (std::size_t d = 0; d < dims; ++d)
+			{
+				low[d] = std::min(low[d], row[d]);
+				high[d] = std::max(high[d], row[d]);
+			}
+		}
+
+		// Row by row
+		reduce(data.size(), dims, low, high, labels, weights, numClasses,
+			[&](std::size_t begin, std::size_t end, std::vector<AttributeStats>* local)
+		{
+			for (std::size_t r = begin; r < end; ++r)
+			{
+				RowView row = data[r];
+				for (std::size_t d = 0; d < numDims; ++d) (*local)[labels[r] * numDims + d].add(row[d], weights[r]);
+			}
+		});
+	}
+
+	// Statistics of attribute d for class c
+	const AttributeStats& get(unsigned int c, std::size_t d) const { return stats[c * numDims + d]; }
+
+	// Number of rows in class c
+	unsigned long long count(unsigned int c) const { return classCounts[c]; }
+
+	// Mean point of class c
+	std::vector<GLfloat> meanPoint(unsigned int c) const
+	{
+		std::vector<GLfloat> point(numDims);
+		for (std::size_t d = 0; d < numDims; ++d) point[d] = (GLfloat)get(c, d).mean;
+		return point;
+	}
+
+private:
+
+	/*
+	* reduce
+	* Run addRows(begin, end, &local) on contiguous blocks of rows in
+	* parallel, each worker into its own accumulators, then merge them.
+	*/
+	template <typename AddRows>
+	void reduce(std::size_t numRows, std::size_t dims, const std::vector<GLfloat>& low, const std::vector<GLfloat>& high,
+		const std::vector<ClassLabel>& labels, const std::vector<unsigned int>& weights, unsigned int numClasses, AddRows addRows)
+	{
+		this->numClasses = numClasses;
+		numDims = dims;
+		stats.assign(numClasses * numDims, AttributeStats());
+		classCounts.assign(numClasses, 0);
+
+		// Sketch every attribute over its full column range
+		std::vector<AttributeStats> empty(numClasses * numDims);
+		for (unsigned int c = 0; c < numClasses; ++c)
+		{
+			for (std::size_t d = 0; d < numDims; ++d)
+			{
+				empty[c * numDims + d].sketch = QuantileSketch(low[d], high[d]);
+			}
+		}
+
+		std::vector<std::vector<AttributeStats>> partial(parallelWorkerCount(), empty);
+		std::vector<std::vector<unsigned long long>> partialCounts(parallelWorkerCount(),
+			std::vector<unsigned long long>(numClasses, 0));
+
+		parallelFor(numRows, [&](std::size_t begin, std::size_t end, unsigned int worker)
+		{
+			for (std::size_t r = begin; r < end; ++r) partialCounts[worker][labels[r]] += weights[r];
+			addRows(begin, end, &partial[worker]);
+		});
+
+		stats = empty;
+		for (std::size_t worker = 0; worker < partial.size(); ++worker)
+		{
+			for (std::size_t i = 0; i < stats.size(); ++i) stats[i].merge(partial[worker][i]);
+			for (unsigned int c = 0; c < numClasses; ++c) classCounts[c] += partialCounts[worker][c];
+		}
+	}
+
+	unsigned int numClasses = 0;					// number of classes
+	std::size_t numDims = 0;						// number of attributes
+	std::vector<AttributeStats> stats{};			// statistics by class, then attribute
+	std::vector<unsigned long long> classCounts{};	// rows per class
+};
@@ -0,0 +1,274 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "GL/glut.h"
+#include "classlabels.h"
+#include "glyphgeometry.h"
+#include "parallel.h"
+
+/* ClutterMetric: overlap and occlusion of a located glyph layout
+*  Every glyph is drawn at three anchors, one in each SPC plot,
+*  and is joined by an edge from each anchor to the next. A glyph's
+*  box is the bounds of its traced segments and crosses within its
+*  viewport, not the whole viewport, which would cover most of the
+*  plots and score every layout alike. Glyph boxes and edges are
+*  rasterized into a coarse occupancy grid over
+*  the window, each worker filling its own grid for its share of
+*  the glyphs before the grids are summed. A glyph counts with the
+*  weight of the data points it stands for. The layout is scored by
+*  the share of glyph area drawn over other glyphs, the share of
+*  each class's glyph area shared with another class, and the
+*  fraction of edges that stay mostly clear of glyphs and other
+*  edges.
+*/
+class ClutterMetric {
+public:
+	/*
+	* ClutterMetric
+	* Constructor.
+	*
+	* @param	width		window width in pixels
+	*			height		window height in pixels
+	*			cellSize	side of a grid cell in pixels
+	*/
+	ClutterMetric(GLfloat width, GLfloat height, GLfloat cellSize = 8.0)
+		: cellSize(cellSize)
+	{
+		columns = std::max(1, (int)std::ceil(width / cellSize));
+		rows = std::max(1, (int)std::ceil(height / cellSize));
+	}
+
+	/*
+	* compute
+	* Rasterize a layout and measure its clutter.
+	*
+	* @param	geometry		traced geometry of the located glyphs
+	*			viewportSize	side of a glyph's viewport in pixels
+	*			labels			class of each glyph
+	*			weights			data points each glyph stands for
+	*			numClasses		number of classes
+	*/
+	void compute(const GlyphGeometry& geometry, GLfloat viewportSize, const std::vector<ClassLabel>& labels,
+		const std::vector<unsigned int>& weights, std::size_t numClasses)
+	{
+		this->numClasses = numClasses;
+		std::size_t numGlyphs = std::min(std::min(labels.size(), weights.size()), geometry.numRows);
+		std::size_t numCells = (std::size_t)columns * rows;
+		locateBoxes(geometry, viewportSize, numGlyphs);
+
+		// Each worker counts the weighted boxes of every class and the edges crossing each cell
+		std::vector<std::vector<unsigned int>> workerBoxes(parallelWorkerCount());
+		std::vector<std::vector<unsigned int>> workerEdges(parallelWorkerCount());
+		parallelFor(numGlyphs, [&](std::size_t begin, std::size_t end, unsigned int worker)
+		{
+			std::vector<unsigned int>& boxes = workerBoxes[worker];
+			std::vector<unsigned int>& edges = workerEdges[worker];
+			boxes.assign(numCells * numClasses, 0);
+			edges.assign(numCells, 0);
+			for (std::size_t g = begin; g < end; ++g)
+			{
+				for (std::size_t k = 0; k < 3; ++k)
+				{
+					forEachBoxCell(&glyphBoxes[12 * g + 4 * k], [&](std::size_t cell) { boxes[cell * numClasses + labels[g]] += weights[g]; });
+				}
+				for (std::size_t k = 0; k < 2; ++k)
+				{
+					forEachEdgeCell(g, k, [&](std::size_t cell) { ++edges[cell]; });
+				}
+			}
+		});
+
+		boxCounts.assign(numCells * numClasses, 0);
+		edgeCounts.assign(numCells, 0);
+		for (std::size_t worker = 0; worker < workerBoxes.size(); ++worker)
+		{
+			if (workerBoxes[worker].empty()) continue;
+			for (std::size_t i = 0; i < boxCounts.size(); ++i) boxCounts[i] += workerBoxes[worker][i];
+			for (std::size_t i = 0; i < edgeCounts.size(); ++i) edgeCounts[i] += workerEdges[worker][i];
+		}
+
+		measureBoxes(numCells);
+		measureEdges(weights, numGlyphs);
+	}
+
+	// Share of glyph box area drawn over another glyph, in [0, 1]
+	GLfloat getOverlapRatio() const { return overlapRatio; }
+
+	// Share of a class's glyph box area shared with glyphs of another class, in [0, 1]
+	GLfloat getOcclusion(ClassLabel label) const { return (label < occlusion.size()) ? occlusion[label] : 0.0f; }
+
+	// Weighted fraction of edges with most of their length clear of glyphs and other edges, in [0, 1]
+	GLfloat getVisibleEdges() const { return visibleEdges; }
+
+private:
+
+	// Box of each located copy of each glyph in window pixels, from the bounds of its
+	// segment ends and cross centers, clipped to the viewport as the glyph is drawn
+	void locateBoxes(const GlyphGeometry& geometry, GLfloat viewportSize, std::size_t numGlyphs)
+	{
+		glyphBoxes.resize(12 * numGlyphs);
+		edgeEnds.resize(6 * numGlyphs);
+		parallelFor(numGlyphs, [&](std::size_t begin, std::size_t end, unsigned int)
+		{
+			for (std::size_t g = begin; g < end; ++g)
+			{
+				// Bounds in viewport coordinates, where the glyph starts at the origin
+				GLfloat xs[6] = { 0.0f, geometry.pos2X[g], geometry.pos3X[g], geometry.crossX[0][g], geometry.crossX[1][g], geometry.crossX[2][g] };
+				GLfloat ys[6] = { 0.0f, geometry.pos2Y[g], geometry.pos3Y[g], geometry.crossY[0][g], geometry.crossY[1][g], geometry.crossY[2][g] };
+				GLfloat left = std::max(-1.0f, *std::min_element(xs, xs + 6));
+				GLfloat right = std::min(1.0f, *std::max_element(xs, xs + 6));
+				GLfloat bottom = std::max(-1.0f, *std::min_element(ys, ys + 6));
+				GLfloat top = std::min(1.0f, *std::max_element(ys, ys + 6));
+
+				for (std::size_t k = 0; k < 3; ++k)
+				{
+					GLfloat* box = &glyphBoxes[12 * g + 4 * k];
+					box[0] = geometry.anchorX[k][g] + (left + 1.0f) * 0.5f * viewportSize;
+					box[1] = geometry.anchorY[k][g] + (bottom + 1.0f) * 0.5f * viewportSize;
+					box[2] = geometry.anchorX[k][g] + (right + 1.0f) * 0.5f * viewportSize;
+					box[3] = geometry.anchorY[k][g] + (top + 1.0f) * 0.5f * viewportSize;
+					edgeEnds[6 * g + 2 * k] = geometry.edgeX[k][g];
+					edgeEnds[6 * g + 2 * k + 1] = geometry.edgeY[k][g];
+				}
+			}
+		});
+	}
+
+	// Overlap ratio and per-class occlusion from the summed box counts
+	void measureBoxes(std::size_t numCells)
+	{
+		unsigned long long area = 0;		// cells covered, counting each box
+		unsigned long long occupied = 0;	// cells covered by at least one box
+		std::vector<unsigned long long> classArea(numClasses, 0);
+		std::vector<unsigned long long> classShared(numClasses, 0);
+		for (std::size_t cell = 0; cell < numCells; ++cell)
+		{
+			const unsigned int* counts = &boxCounts[cell * numClasses];
+			unsigned long long total = 0;
+			for (std::size_t c = 0; c < numClasses; ++c) total += counts[c];
+			if (total == 0) continue;
+
+			area += total;
+			++occupied;
+			for (std::size_t c = 0; c < numClasses; ++c)
+			{
+				classArea[c] += counts[c];
+				if (counts[c] < total) classShared[c] += counts[c];
+			}
+		}
+
+		overlapRatio = (area > 0) ? (GLfloat)(area - occupied) / area : 0.0f;
+		occlusion.assign(numClasses, 0.0);
+		for (std::size_t c = 0; c < numClasses; ++c)
+		{
+			if (classArea[c] > 0) occlusion[c] = (GLfloat)classShared[c] / classArea[c];
+		}
+	}
+
+	// Weigh the edges whose cells are mostly free of boxes and of other edges
+	void measureEdges(const std::vector<unsigned int>& weights, std::size_t numGlyphs)
+	{
+		// A cell is blocked when a box or a second edge covers it
+		std::vector<unsigned char> blocked(edgeCounts.size());
+		for (std::size_t cell = 0; cell < blocked.size(); ++cell)
+		{
+			blocked[cell] = edgeCounts[cell] != 1 || hasBox(cell);
+		}
+
+		std::vector<unsigned long long> workerVisible(parallelWorkerCount(), 0);
+		parallelFor(numGlyphs, [&](std::size_t begin, std::size_t end, unsigned int worker)
+		{
+			for (std::size_t g = begin; g < end; ++g)
+			{
+				for (std::size_t k = 0; k < 2; ++k)
+				{
+					unsigned int clear = 0;
+					unsigned int total = 0;
+					forEachEdgeCell(g, k, [&](std::size_t cell)
+					{
+						++total;
+						if (!blocked[cell]) ++clear;
+					});
+					if (total > 0 && 2 * clear >= total) workerVisible[worker] += weights[g];
+				}
+			}
+		});
+
+		unsigned long long visible = 0;
+		unsigned long long total = 0;
+		for (auto count : workerVisible) visible += count;
+		for (std::size_t g = 0; g < numGlyphs; ++g) total += weights[g];
+		visibleEdges = (total > 0) ? (GLfloat)visible / (2 * total) : 0.0f;
+	}
+
+	bool hasBox(std::size_t cell) const
+	{
+		for (std::size_t c = 0; c < numClasses; ++c)
+		{
+			if (boxCounts[cell * numClasses + c] > 0) return true;
+		}
+		return false;
+	}
+
+	// Visit every cell covered by a box (left, bottom, right, top)
+	template <typename Visit>
+	void forEachBoxCell(const GLfloat* box, Visit visit) const
+	{
+		int left = std::max(0, (int)std::floor(box[0] / cellSize));
+		int right = std::min(columns - 1, (int)std::floor(box[2] / cellSize));
+		int bottom = std::max(0, (int)std::floor(box[1] / cellSize));
+		int top = std::min(rows - 1, (int)std::floor(box[3] / cellSize));
+		for (int row = bottom; row <= top; ++row)
+		{
+			for (int column = left; column <= right; ++column) visit((std::size_t)row * columns + column);
+		}
+	}
+
+	// Visit every cell along a glyph's edge from its copy k to copy k + 1, outside the boxes of both copies
+	template <typename Visit>
+	void forEachEdgeCell(std::size_t g, std::size_t k, Visit visit) const
+	{
+		const GLfloat* from = &edgeEnds[6 * g + 2 * k];
+		const GLfloat* to = from + 2;
+		const GLfloat* fromBox = &glyphBoxes[12 * g + 4 * k];
+		const GLfloat* toBox = fromBox + 4;
+		GLfloat dx = (to[0] - from[0]) / cellSize;
+		GLfloat dy = (to[1] - from[1]) / cellSize;
+		int steps = std::max(1, (int)std::ceil(std::max(std::abs(dx), std::abs(dy))));
+
+		GLfloat stepX = (to[0] - from[0]) / steps;
+		GLfloat stepY = (to[1] - from[1]) / steps;
+		long long previous = -1;
+		for (int i = 0; i <= steps; ++i)
+		{
+			GLfloat x = from[0] + stepX * i;
+			GLfloat y = from[1] + stepY * i;
+			if (x < 0.0 || y < 0.0 || inside(fromBox, x, y) || inside(toBox, x, y)) continue;
+			int column = (int)(x / cellSize);
+			int row = (int)(y / cellSize);
+			if (column >= columns || row >= rows) continue;
+
+			long long cell = (long long)row * columns + column;
+			if (cell != previous) visit((std::size_t)cell);	// visit each cell once per edge
+			previous = cell;
+		}
+	}
+
+	static bool inside(const GLfloat* box, GLfloat x, GLfloat y)
+	{
+		return x >= box[0] && x <= box[2] && y >= box[1] && y <= box[3];
+	}
+
+	GLfloat cellSize;						// side of a grid cell in pixels
+	int columns = 1;						// grid cells across the window
+	int rows = 1;							// grid cells up the window
+	std::size_t numClasses = 0;				// number of classes
+	std::vector<GLfloat> glyphBoxes{};		// box (left, bottom, right, top) of each located copy of each glyph
+	std::vector<GLfloat> edgeEnds{};		// edge end (x, y) of each located copy of each glyph
+	std::vector<unsigned int> boxCounts{};	// weighted glyph boxes per cell and class
+	std::vector<unsigned int> edgeCounts{};	// edges crossing each cell
+	GLfloat overlapRatio = 0.0;				// share of box area drawn over another box
+	std::vector<GLfloat> occlusion{};		// share of each class's box area shared with another class
+	GLfloat visibleEdges = 0.0;				// weighted fraction of mostly clear edges
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include "GL/glut.h"
+
+/* RowView: non-owning view of a single data point
+*  Refers to the attributes of a row stored elsewhere,
+*  so rows can be passed to analysis and drawing code
+*  without copying them.
+*/
+struct RowView {
+	const GLfloat* data = nullptr;	// first attribute of the row
+	std::size_t count = 0;			// number of attributes
+
+	// Constructor
+	RowView() {}
+
+	// Constructor: view of an existing data point
+	RowView(const std::vector<GLfloat>& row) : data(row.data()), count(row.size()) {}
+
+	// Constructor: view of count attributes starting at data
+	RowView(const GLfloat* data, std::size_t count) : data(data), count(count) {}
+
+	GLfloat operator[](std::size_t i) const { return data[i]; }
+	std::size_t size() const { return count; }
+	const GLfloat* begin() const { return data; }
+	const GLfloat* end() const { return data + count; }
+};
+
+/* DataView: non-owning view of a data set and a selection of its rows
+*  Rows are referred to by their id (index in the underlying data set),
+*  so subsets such as clusters or the remaining unclustered points are
+*  lists of ids rather than copies of the rows themselves. A view of
+*  every row stores no ids at all: the i-th row is the row with id i.
+*/
+class DataView {
+public:
+	/*
+	* DataView
+	* Constructor. View every row of the data set.
+	*
+	* @param	rows	underlying data set
+	*/
+	DataView(const std::vector<std::vector<GLfloat>>& rows) : rows(&rows), count(rows.size()), everyRow(true) {}
+
+	/*
+	* DataView
+	* Constructor. View the selected rows of the data set.
+	*
+	* @param	rows	underlying data set
+	*			ids		ids of the selected rows
+	*/
+	DataView(const std::vector<std::vector<GLfloat>>& rows, const std::vector<unsigned int>& ids)
+		: rows(&rows), ids(ids), count(ids.size()), everyRow(false) {}
+
+	// Number of selected rows
+	std::size_t size() const { return count; }
+
+	// Id of the i-th selected row
+	unsigned int id(std::size_t i) const { return everyRow ? (unsigned int)i : ids[i]; }
+
+	// View of the i-th selected row
+	RowView operator[](std::size_t i) const { return RowView((*rows)[id(i)]); }
+
+	// View of a row by its id
+	RowView row(unsigned int rowId) const { return RowView((*rows)[rowId]); }
+
+	// Get the ids of the selected rows, listing them if the view is of every row
+	std::vector<unsigned int> getIds() const
+	{
+		if (!everyRow) return ids;
+		std::vector<unsigned int> all(count);
+		for (unsigned int i = 0; i < all.size(); ++i) all[i] = i;
+		return all;
+	}
+
+	// Get the underlying data set
+	const std::vector<std::vector<GLfloat>>& getRows() const { return *rows; }
+
+private:
+	const std::vector<std::vector<GLfloat>>* rows;	// underlying data set
+	std::vector<unsigned int> ids{};				// ids of the selected rows, empty for a view of every row
+	std::size_t count;								// number of selected rows
+	bool everyRow;									// view of every row, in id order
+};
@@ -0,0 +1,285 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include "GL/glut.h"
+#include "classlabels.h"
+#include "dataview.h"
+#include "hyperblock.h"
+#include "parallel.h"
+
+/* DecisionTree: axis-aligned classification tree with histogram splits
+*  Every attribute is first cut into equal-width bins over its range
+*  and stored as a column of bin ids. A node then finds its split by
+*  summing the class counts of its rows into one histogram per
+*  attribute, in parallel across attributes, and scanning each
+*  histogram once for the bin boundary with the lowest weighted Gini
+*  impurity. The cost of a node is one pass over its rows plus the
+*  bins, independent of how many distinct values an attribute has.
+*  Each leaf is an axis-aligned region of attribute space, and the
+*  rows reaching it give its class and its bounding hyperblock.
+*/
+class DecisionTree {
+public:
+	// Node of the tree: a split on one attribute, or a leaf (attribute -1)
+	struct Node {
+		int attribute = -1;			// attribute split on, -1 for a leaf
+		GLfloat threshold = 0.0;	// rows with a value below go left
+		int left = -1;				// node of the rows below the threshold
+		int right = -1;				// node of the rows at or above the threshold
+		ClassLabel classLabel = 0;	// dominant class of the rows reaching the node
+		unsigned int weight = 0;	// data points reaching the node
+	};
+
+	/*
+	* DecisionTree
+	* Constructor.
+	*
+	* @param	maxDepth	maximum number of splits from the root to a leaf
+	*			minLeaf		fewest data points on either side of a split
+	*			bins		bins per attribute, at most 256
+	*/
+	DecisionTree(unsigned int maxDepth = 4, unsigned int minLeaf = 5, unsigned int bins = 32)
+		: maxDepth(maxDepth), minLeaf(minLeaf), bins(std::min(std::max(bins, 2u), 256u)) {}
+
+	/*
+	* train
+	* Grow the tree on weighted rows, replacing any previous tree.
+	*
+	* @param	data		rows to train on
+	*			counts		class counts of every row of the data's table, by row id
+	*/
+	void train(const DataView& data, const RowCounts& counts)
+	{
+		nodes.clear();
+		leafRows.clear();
+		rowIds.resize(data.size());
+		for (std::size_t i = 0; i < data.size(); ++i) rowIds[i] = data.id(i);
+		numClasses = counts.getNumClasses();
+		numAttributes = (data.size() == 0) ? 0 : data[0].size();
+		binColumns(data);
+
+		std::vector<unsigned int> rows(data.size());
+		for (unsigned int i = 0; i < rows.size(); ++i) rows[i] = i;
+		grow(rows, counts, 0);
+	}
+
+	/*
+	* predict
+	* Follow a row from the root to its leaf.
+	*
+	* @param	row		row to classify
+	* @return			class of the leaf reached
+	*/
+	ClassLabel predict(RowView row) const
+	{
+		if (nodes.empty()) return 0;
+		int node = 0;
+		while (nodes[node].attribute >= 0)
+		{
+			const Node& split = nodes[node];
+			node = (row[split.attribute] < split.threshold) ? split.left : split.right;
+		}
+		return nodes[node].classLabel;
+	}
+
+	/*
+	* leafBlocks
+	* Bound the training rows reaching each leaf, labelled with the
+	* leaf's class.
+	*
+	* @param	data	rows the tree was trained on
+	* @return			one hyperblock per leaf holding rows
+	*/
+	std::vector<Hyperblock> leafBlocks(const DataView& data) const
+	{
+		std::vector<Hyperblock> blocks{};
+		for (std::size_t leaf = 0; leaf < leafRows.size(); ++leaf)
+		{
+			const std::vector<unsigned int>& rows = leafRows[leaf].second;
+			if (rows.empty()) continue;
+
+			std::vector<unsigned int> ids(rows.size());
+			for (std::size_t i = 0; i < rows.size(); ++i) ids[i] = data.id(rows[i]);
+			const Node& node = nodes[leafRows[leaf].first];
+			Hyperblock block = Hyperblock::fromPoints(DataView(data.getRows(), ids), node.classLabel,
+				"DT" + std::to_string(blocks.size() + 1));
+			block.size = node.weight;
+			blocks.push_back(block);
+		}
+		return blocks;
+	}
+
+	// Nodes of the tree, root first
+	const std::vector<Node>& getNodes() const { return nodes; }
+
+private:
+
+	// Cut every attribute into equal-width bins and store the bin of each row, in parallel across attributes
+	void binColumns(const DataView& data)
+	{
+		columns.assign(numAttributes, std::vector<std::uint8_t>(data.size(), 0));
+		lowest.assign(numAttributes, 0.0f);
+		binWidth.assign(numAttributes, 0.0f);
+		parallelFor(numAttributes, [&](std::size_t begin, std::size_t end, unsigned int)
+		{
+			for (std::size_t a = begin; a < end; ++a)
+			{
+				GLfloat low = data[0][a];
+				GLfloat high = low;
+				for (std::size_t r = 0; r < data.size(); ++r)
+				{
+					low = std::min(low, data[r][a]);
+					high = std::max(high, data[r][a]);
+				}
+				lowest[a] = low;
+				binWidth[a] = (high - low) / bins;
+
+				for (std::size_t r = 0; r < data.size(); ++r)
+				{
+					int b = (binWidth[a] > 0.0f) ? (int)((data[r][a] - low) / binWidth[a]) : 0;
+					columns[a][r] = (std::uint8_t)std::min(std::max(b, 0), (int)bins - 1);
+				}
+			}
+		});
+	}
+
+	// Weighted Gini impurity of a class histogram, times its weight
+	double giniMass(const double* classCounts) const
+	{
+		double total = 0.0;
+		double squares = 0.0;
+		for (std::size_t c = 0; c < numClasses; ++c)
+		{
+			total += classCounts[c];
+			squares += classCounts[c] * classCounts[c];
+		}
+		return (total > 0.0) ? total - squares / total : 0.0;
+	}
+
+	// Grow the subtree of a set of rows, returning its node
+	int grow(const std::vector<unsigned int>& rows, const RowCounts& counts, unsigned int depth)
+	{
+		int id = (int)nodes.size();
+		nodes.push_back(Node());
+
+		ClassHistogram classes(numClasses);
+		for (unsigned int row : rows) counts.addTo(rowIds[row], &classes);
+		nodes[id].classLabel = classes.dominant();
+		nodes[id].weight = classes.getTotal();
+
+		// Best split of each attribute: bin boundary and impurity left after it
+		std::vector<int> bestBin(numAttributes, -1);
+		std::vector<double> bestMass(numAttributes, 0.0);
+		if (depth < maxDepth && classes.purity() < 1.0f && classes.getTotal() >= 2 * minLeaf)
+		{
+			parallelFor(numAttributes, [&](std::size_t begin, std::size_t end, unsigned int)
+			{
+				std::vector<double> histogram(bins * numClasses);
+				std::vector<double> below(numClasses);
+				std::vector<double> above(numClasses);
+				for (std::size_t a = begin; a < end; ++a)
+				{
+					std::fill(histogram.begin(), histogram.end(), 0.0);
+					for (unsigned int row : rows)
+					{
+						double* bin = &histogram[columns[a][row] * numClasses];
+						for (std::size_t c = 0; c < numClasses; ++c) bin[c] += counts.count(rowIds[row], (ClassLabel)c);
+					}
+
+					std::fill(below.begin(), below.end(), 0.0);
+					for (std::size_t c = 0; c < numClasses; ++c) above[c] = classes.count((ClassLabel)c);
+					for (unsigned int b = 0; b + 1 < bins; ++b)
+					{
+						double belowWeight = 0.0;
+						for (std::size_t c = 0; c < numClasses; ++c)
+						{
+							below[c] += histogram[b * numClasses + c];
+							above[c] -= histogram[b * numClasses + c];
+							belowWeight += below[c];
+						}
+						if (belowWeight < minLeaf || classes.getTotal() - belowWeight < minLeaf) continue;
+
+						double mass = giniMass(below.data()) + giniMass(above.data());
+						if (bestBin[a] < 0 || mass < bestMass[a])
+						{
+							bestBin[a] = (int)b;
+							bestMass[a] = mass;
+						}
+					}
+				}
+			});
+		}
+
+		// Take the attribute leaving the least impurity, if it leaves less than the node has
+		std::vector<double> nodeCounts = histogramOf(classes);
+		int attribute = -1;
+		double leastMass = giniMass(nodeCounts.data());
+		for (std::size_t a = 0; a < numAttributes; ++a)
+		{
+			if (bestBin[a] >= 0 && bestMass[a] < leastMass)
+			{
+				attribute = (int)a;
+				leastMass = bestMass[a];
+			}
+		}
+
+		if (attribute < 0)
+		{
+			leafRows.push_back({ id, rows });
+			return id;
+		}
+
+		// Rows in bins up to the boundary go left
+		std::vector<unsigned int> leftRows{};
+		std::vector<unsigned int> rightRows{};
+		for (unsigned int row : rows)
+		{
+			if (columns[attribute][row] <= bestBin[attribute]) leftRows.push_back(row);
+			else rightRows.push_back(row);
+		}
+
+		nodes[id].attribute = attribute;
+		nodes[id].threshold = lowest[attribute] + binWidth[attribute] * (bestBin[attribute] + 1);
+		int left = grow(leftRows, counts, depth + 1);
+		int right = grow(rightRows, counts, depth + 1);
+
+		// Two leaves of the same class are one region, so the node becomes their leaf
+		if (nodes[left].attribute < 0 && nodes[right].attribute < 0
+			&& nodes[left].classLabel == nodes[right].classLabel)
+		{
+			nodes.resize(id + 1);
+			leafRows.resize(leafRows.size() - 2);
+			nodes[id].attribute = -1;
+			nodes[id].threshold = 0.0;
+			leafRows.push_back({ id, rows });
+			return id;
+		}
+
+		nodes[id].left = left;
+		nodes[id].right = right;
+		return id;
+	}
+
+	// Class counts of a histogram as doubles
+	std::vector<double> histogramOf(const ClassHistogram& classes) const
+	{
+		std::vector<double> classCounts(numClasses);
+		for (std::size_t c = 0; c < numClasses; ++c) classCounts[c] = classes.count((ClassLabel)c);
+		return classCounts;
+	}
+
+	unsigned int maxDepth;									// maximum depth of a leaf
+	unsigned int minLeaf;									// fewest data points on either side of a split
+	unsigned int bins;										// bins per attribute
+	std::size_t numClasses = 0;								// classes of the training rows
+	std::size_t numAttributes = 0;							// attributes of the training rows
+	std::vector<std::vector<std::uint8_t>> columns{};		// bin of each row, per attribute
+	std::vector<unsigned int> rowIds{};						// row id in the counts of each training row
+	std::vector<GLfloat> lowest{};							// lowest value of each attribute
+	std::vector<GLfloat> binWidth{};						// bin width of each attribute
+	std::vector<Node> nodes{};								// nodes, root first
+	std::vector<std::pair<int, std::vector<unsigned int>>> leafRows{};	// node and training rows of each leaf
+};
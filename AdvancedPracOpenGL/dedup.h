@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <cstdint>
+#include "GL/glut.h"
+#include "classlabels.h"
+
+// Hash the attribute values of a row (FNV-1a over the value bits)
+inline std::size_t hashRow(const std::vector<GLfloat>& row)
+{
+	std::uint64_t hash = 14695981039346656037ULL;
+	for (GLfloat value : row)
+	{
+		GLfloat canonical = value + 0.0f;	// -0 and +0 compare equal, so hash them equally
+		std::uint32_t bits = 0;
+		std::memcpy(&bits, &canonical, sizeof(bits));
+		hash = (hash ^ bits) * 1099511628211ULL;
+	}
+	return (std::size_t)hash;
+}
+
+/*
+* deduplicateRows
+* Collapse identical rows into a single row weighted by the number
+* of data points it stands for in each class. Unique rows keep the
+* order of their first occurrence, and each is labelled with its
+* dominant class.
+*
+* @param	rows		data set, replaced by its unique rows
+*			classify	class of each row, replaced by the dominant class of each unique row
+* @return	class counts of each unique row
+*/
+inline RowCounts deduplicateRows(std::vector<std::vector<GLfloat>>* rows, LabelColumn* classify)
+{
+	RowCounts counts(classify->numClasses());
+	std::vector<std::vector<GLfloat>> unique{};
+	std::unordered_map<std::size_t, std::vector<unsigned int>> buckets{};	// unique row ids by hash
+
+	for (std::size_t i = 0; i < rows->size(); ++i)
+	{
+		std::vector<GLfloat>& row = (*rows)[i];
+		std::vector<unsigned int>& bucket = buckets[hashRow(row)];
+
+		// Look for an identical unique row among those with the same hash
+		int uniqueId = -1;
+		for (unsigned int candidate : bucket)
+		{
+			if (unique[candidate] == row)
+			{
+				uniqueId = (int)candidate;
+				break;
+			}
+		}
+
+		if (uniqueId < 0)
+		{	// First occurrence of this row
+			uniqueId = (int)unique.size();
+			bucket.push_back((unsigned int)uniqueId);
+			unique.push_back(std::move(row));
+			counts.addRow();
+		}
+		counts.add((std::size_t)uniqueId, (*classify)[i]);
+	}
+
+	// Label each unique row with its dominant class, keeping the class dictionary
+	LabelColumn uniqueClass{};
+	for (ClassLabel label = 0; label < classify->numClasses(); ++label)
+	{
+		uniqueClass.addClass(classify->name(label));
+	}
+	for (std::size_t row = 0; row < counts.size(); ++row)
+	{
+		uniqueClass.push_back(counts.dominant(row));
+	}
+
+	rows->swap(unique);
+	*classify = uniqueClass;
+	return counts;
+}
@@ -0,0 +1,343 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "GL/glut.h"
+#include "classlabels.h"
+#include "glyphgeometry.h"
+#include "parallel.h"
+
+// Mapping of accumulated density to opacity
+enum class ToneMapping {
+	Log,		// log(1 + density), relative to the densest pixel
+	Equalized	// share of covered pixels with lower density
+};
+
+/* DensityMap: per-class density of located glyph edges and anchors
+*  Edges between the located copies of every glyph, and the copies
+*  themselves, are splatted into one float buffer per class at
+*  window resolution. Edge and anchor ends are snapped to pixels
+*  first and identical ones merged with their counts as weights, so
+*  overplotted rows cost one splat. Splatting runs in parallel over
+*  horizontal bands of the window, each worker writing only its own
+*  rows. The buffers are then tone-mapped into one RGBA image, each
+*  pixel colored by the mix of classes over it.
+*/
+class DensityMap {
+public:
+	// Line or point of one class in window pixels, with the number of items sharing it
+	struct Splat {
+		ClassLabel label;
+		int x0, y0, x1, y1;
+		float weight;
+	};
+
+	/*
+	* resize
+	* Size the buffers for a window and a number of classes, reusing
+	* their storage, and clear them.
+	*
+	* @param	width, height	window size in pixels
+	*			numClasses		number of classes
+	*/
+	void resize(int width, int height, std::size_t numClasses)
+	{
+		this->width = std::max(1, width);
+		this->height = std::max(1, height);
+		this->numClasses = numClasses;
+		densities.resize(numClasses);
+		for (auto& density : densities) density.assign((std::size_t)this->width * this->height, 0.0f);
+	}
+
+	/*
+	* accumulate
+	* Splat the edges and anchors of every traced glyph.
+	*
+	* @param	geometry	traced geometry of the located glyphs
+	*			labels		class of each glyph
+	*/
+	void accumulate(const GlyphGeometry& geometry, const std::vector<ClassLabel>& labels)
+	{
+		std::size_t numGlyphs = std::min(geometry.numRows, labels.size());
+
+		// Snap every edge and anchor to pixels, per worker
+		std::vector<std::vector<std::uint64_t>> workerEdges(parallelWorkerCount());
+		std::vector<std::vector<std::uint64_t>> workerAnchors(parallelWorkerCount());
+		parallelFor(numGlyphs, [&](std::size_t begin, std::size_t end, unsigned int worker)
+		{
+			std::vector<std::uint64_t>& edges = workerEdges[worker];
+			std::vector<std::uint64_t>& anchors = workerAnchors[worker];
+			for (std::size_t g = begin; g < end; ++g)
+			{
+				for (std::size_t k = 0; k < 3; ++k)
+				{
+					anchors.push_back(key(labels[g], geometry.edgeX[k][g], geometry.edgeY[k][g], 0.0f, 0.0f));
+					if (k < 2)
+					{
+						edges.push_back(key(labels[g], geometry.edgeX[k][g], geometry.edgeY[k][g],
+							geometry.edgeX[k + 1][g], geometry.edgeY[k + 1][g]));
+					}
+				}
+			}
+		});
+		std::vector<Splat> edges = merge(&workerEdges);
+		std::vector<Splat> anchors = merge(&workerAnchors);
+
+		// Each worker splats everything that crosses its band of rows
+		parallelFor((std::size_t)height, [&](std::size_t begin, std::size_t end, unsigned int)
+		{
+			int bottom = (int)begin;
+			int top = (int)end;
+			for (const Splat& edge : edges) splatLine(edge, bottom, top);
+			for (const Splat& anchor : anchors) splatBox(anchor, bottom, top);
+		});
+	}
+
+	/*
+	* accumulateLines
+	* Splat weighted lines that are already snapped to pixels.
+	*
+	* @param	lines	lines to add, each with its class and weight
+	*/
+	void accumulateLines(const std::vector<Splat>& lines)
+	{
+		parallelFor((std::size_t)height, [&](std::size_t begin, std::size_t end, unsigned int)
+		{
+			for (const Splat& line : lines) splatLine(line, (int)begin, (int)end);
+		});
+	}
+
+	/*
+	* toneMap
+	* Map the accumulated densities to an RGBA image, rows from the
+	* bottom of the window up.
+	*
+	* @param	mode		mapping of density to opacity
+	*			palette		red, green and blue of each class
+	*			rgba		output image, four bytes per pixel
+	*/
+	void toneMap(ToneMapping mode, const std::vector<GLfloat>& palette, std::vector<GLubyte>* rgba) const
+	{
+		std::size_t numPixels = (std::size_t)width * height;
+		std::vector<float> totals(numPixels, 0.0f);
+		for (const auto& density : densities)
+		{
+			for (std::size_t p = 0; p < numPixels; ++p) totals[p] += density[p];
+		}
+		float maxTotal = totals.empty() ? 0.0f : *std::max_element(totals.begin(), totals.end());
+		float logMax = std::log1p(maxTotal);
+
+		// Cumulative share of covered pixels by log density, for equalization
+		const std::size_t bins = 1024;
+		std::vector<float> cumulative(bins, 0.0f);
+		if (mode == ToneMapping::Equalized && maxTotal > 0.0f)
+		{
+			std::vector<std::size_t> counts(bins, 0);
+			std::size_t covered = 0;
+			for (float total : totals)
+			{
+				if (total <= 0.0f) continue;
+				++counts[bin(total, logMax, bins)];
+				++covered;
+			}
+			std::size_t running = 0;
+			for (std::size_t b = 0; b < bins; ++b)
+			{
+				running += counts[b];
+				cumulative[b] = (float)running / covered;
+			}
+		}
+
+		rgba->assign(4 * numPixels, 0);
+		parallelFor(numPixels, [&](std::size_t begin, std::size_t end, unsigned int)
+		{
+			for (std::size_t p = begin; p < end; ++p)
+			{
+				float total = totals[p];
+				if (total <= 0.0f) continue;
+
+				float color[3] = { 0.0f, 0.0f, 0.0f };
+				for (std::size_t c = 0; c < numClasses; ++c)
+				{
+					float share = densities[c][p] / total;
+					for (unsigned int i = 0; i < 3; ++i) color[i] += share * palette[3 * c + i];
+				}
+				float opacity = (mode == ToneMapping::Log) ? std::log1p(total) / logMax : cumulative[bin(total, logMax, bins)];
+
+				GLubyte* pixel = &(*rgba)[4 * p];
+				for (unsigned int i = 0; i < 3; ++i) pixel[i] = (GLubyte)(255.0f * color[i] + 0.5f);
+				pixel[3] = (GLubyte)(255.0f * opacity + 0.5f);
+			}
+		});
+	}
+
+	// Window width of the buffers in pixels
+	int getWidth() const { return width; }
+
+	// Window height of the buffers in pixels
+	int getHeight() const { return height; }
+
+private:
+	// Offset and bits of a snapped coordinate in a key, allowing ends somewhat off the window
+	static const int coordinateOffset = 1024;
+	static const int coordinateBits = 13;
+
+	// Pack a class and two snapped points into a sortable key
+	static std::uint64_t key(ClassLabel label, GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1)
+	{
+		std::uint64_t packed = label & 0xFFF;
+		for (GLfloat coordinate : { x0, y0, x1, y1 })
+		{
+			int snapped = (int)std::floor(coordinate) + coordinateOffset;
+			snapped = std::min(std::max(snapped, 0), (1 << coordinateBits) - 1);
+			packed = (packed << coordinateBits) | (std::uint64_t)snapped;
+		}
+		return packed;
+	}
+
+	// Sort the keys of all workers and merge equal ones into weighted splats
+	static std::vector<Splat> merge(std::vector<std::vector<std::uint64_t>>* workerKeys)
+	{
+		std::vector<std::uint64_t> keys{};
+		for (auto& worker : *workerKeys) keys.insert(keys.end(), worker.begin(), worker.end());
+		std::sort(keys.begin(), keys.end());
+
+		std::vector<Splat> splats{};
+		const std::uint64_t mask = (1 << coordinateBits) - 1;
+		for (std::size_t i = 0; i < keys.size();)
+		{
+			std::size_t run = i;
+			while (run < keys.size() && keys[run] == keys[i]) ++run;
+
+			std::uint64_t packed = keys[i];
+			Splat splat{};
+			splat.y1 = (int)(packed & mask) - coordinateOffset;
+			splat.x1 = (int)((packed >> coordinateBits) & mask) - coordinateOffset;
+			splat.y0 = (int)((packed >> (2 * coordinateBits)) & mask) - coordinateOffset;
+			splat.x0 = (int)((packed >> (3 * coordinateBits)) & mask) - coordinateOffset;
+			splat.label = (ClassLabel)(packed >> (4 * coordinateBits));
+			splat.weight = (float)(run - i);
+			splats.push_back(splat);
+			i = run;
+		}
+		return splats;
+	}
+
+	// Add the weight of an edge to the pixels it crosses in rows [bottom, top)
+	void splatLine(const Splat& edge, int bottom, int top)
+	{
+		if (std::max(edge.y0, edge.y1) < bottom || std::min(edge.y0, edge.y1) >= top) return;
+
+		int dx = edge.x1 - edge.x0;
+		int dy = edge.y1 - edge.y0;
+		int steps = std::max(1, std::max(std::abs(dx), std::abs(dy)));
+
+		// Only step through the part of the edge inside the band
+		int first = 0;
+		int last = steps;
+		if (dy != 0)
+		{
+			float enter = (float)(((dy > 0) ? bottom : top - 1) - edge.y0) / dy;
+			float leave = (float)(((dy > 0) ? top - 1 : bottom) - edge.y0) / dy;
+			first = std::max(0, (int)std::floor(enter * steps) - 1);
+			last = std::min(steps, (int)std::ceil(leave * steps) + 1);
+		}
+
+		// Step in 16.16 fixed point, rounding to the nearest pixel
+		std::vector<float>& density = densities[edge.label];
+		std::int64_t stepX = ((std::int64_t)dx << 16) / steps;
+		std::int64_t stepY = ((std::int64_t)dy << 16) / steps;
+		std::int64_t x = ((std::int64_t)edge.x0 << 16) + stepX * first + 0x8000;
+		std::int64_t y = ((std::int64_t)edge.y0 << 16) + stepY * first + 0x8000;
+		for (int i = first; i <= last; ++i, x += stepX, y += stepY)
+		{
+			int column = (int)(x >> 16);
+			int row = (int)(y >> 16);
+			if (row < bottom || row >= top || column < 0 || column >= width) continue;
+			density[(std::size_t)row * width + column] += edge.weight;
+		}
+	}
+
+	// Add the weight of an anchor to the 3 x 3 pixels around it in rows [bottom, top)
+	void splatBox(const Splat& anchor, int bottom, int top)
+	{
+		std::vector<float>& density = densities[anchor.label];
+		for (int row = std::max(bottom, anchor.y0 - 1); row <= std::min(top - 1, anchor.y0 + 1); ++row)
+		{
+			for (int column = std::max(0, anchor.x0 - 1); column <= std::min(width - 1, anchor.x0 + 1); ++column)
+			{
+				density[(std::size_t)row * width + column] += anchor.weight;
+			}
+		}
+	}
+
+	// Histogram bin of a density, by its log relative to the densest pixel
+	static std::size_t bin(float total, float logMax, std::size_t bins)
+	{
+		std::size_t b = (std::size_t)(std::log1p(total) / logMax * (bins - 1));
+		return std::min(b, bins - 1);
+	}
+
+	int width = 1;									// window width in pixels
+	int height = 1;									// window height in pixels
+	std::size_t numClasses = 0;						// number of classes
+	std::vector<std::vector<float>> densities{};	// accumulated weight per class and pixel, rows from the bottom
+};
+
+/* DensityTexture: a tone-mapped density image drawn over the window
+*  The image is uploaded as a single texture and drawn on one quad
+*  covering the window, blended over what is already drawn.
+*/
+class DensityTexture {
+public:
+	// Upload an RGBA image, rows from the bottom up
+	void upload(int width, int height, const std::vector<GLubyte>& rgba)
+	{
+		if (texture == 0) glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.empty() ? nullptr : &rgba[0]);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	/*
+	* draw
+	* Draw the texture over the window. The caller sets up a projection
+	* that maps window coordinates to the screen.
+	*
+	* @param	width, height	window size in pixels
+	*/
+	void draw(int width, int height) const
+	{
+		if (texture == 0) return;
+
+		glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT);
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+		glColor4f(1.0, 1.0, 1.0, 1.0);
+
+		glBegin(GL_QUADS);
+		glTexCoord2f(0.0, 0.0);
+		glVertex2f(0.0, 0.0);
+		glTexCoord2f(1.0, 0.0);
+		glVertex2f((GLfloat)width, 0.0);
+		glTexCoord2f(1.0, 1.0);
+		glVertex2f((GLfloat)width, (GLfloat)height);
+		glTexCoord2f(0.0, 1.0);
+		glVertex2f(0.0, (GLfloat)height);
+		glEnd();
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glPopAttrib();
+	}
+
+private:
+	GLuint texture = 0;		// texture holding the image
+};
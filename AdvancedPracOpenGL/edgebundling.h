@@ -0,0 +1,352 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include "GL/glut.h"
+#include "parallel.h"
+
+/* EdgeBundler: force-directed bundling of straight edges
+*  Each edge becomes a polyline whose inner points are pulled toward
+*  the matching points of compatible edges (similar direction,
+*  length and position, and in view of each other) and held back by
+*  springs along the edge. The polylines start with one inner point
+*  and are refined over several cycles, each doubling the points,
+*  halving the step and running fewer iterations. Compatible pairs
+*  are only looked for among edges whose midpoints share or
+*  neighbor a cell of a grid sized so that farther pairs cannot
+*  pass the compatibility threshold, and each edge keeps only its
+*  most compatible ones. Every iteration moves all edges in
+*  parallel from the previous positions.
+*
+*  Edges are snapped to pixels, and identical edges are bundled once
+*  with their count as weight. The bundled polylines are kept: the
+*  same edge set again costs nothing, and a changed set starts its
+*  known edges from their kept polylines and only runs the last
+*  cycle.
+*/
+class EdgeBundler {
+public:
+	// Straight edge in window pixels
+	struct Edge {
+		GLfloat x0, y0, x1, y1;
+	};
+
+	/*
+	* EdgeBundler
+	* Constructor.
+	*
+	* @param	cycles			refinement cycles, each doubling the points of the polylines
+	*			iterations		iterations of the first cycle
+	*			stiffness		spring constant along each edge
+	*			threshold		least compatibility of two edges that attract
+	*			maxNeighbors	most compatible edges pulling each edge
+	*/
+	EdgeBundler(unsigned int cycles = 5, unsigned int iterations = 50, GLfloat stiffness = 0.5f, GLfloat threshold = 0.6f,
+		unsigned int maxNeighbors = 32)
+		: cycles(std::max(cycles, 1u)), iterations(iterations), stiffness(stiffness), threshold(threshold), maxNeighbors(maxNeighbors) {}
+
+	/*
+	* bundle
+	* Bundle a set of edges, reusing the polylines of the previous set
+	* where the edges are the same.
+	*
+	* @param	edges	edges to bundle
+	*/
+	void bundle(const std::vector<Edge>& edges)
+	{
+		// Snap the edges and merge identical ones
+		std::vector<std::uint64_t> edgeKeys(edges.size());
+		for (std::size_t e = 0; e < edges.size(); ++e) edgeKeys[e] = key(edges[e]);
+		std::vector<std::uint64_t> keys(edgeKeys);
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+		edgeIndex.resize(edges.size());
+		for (std::size_t e = 0; e < edges.size(); ++e)
+		{
+			edgeIndex[e] = (unsigned int)(std::lower_bound(keys.begin(), keys.end(), edgeKeys[e]) - keys.begin());
+		}
+		if (keys == bundledKeys) return;
+
+		std::vector<GLfloat> weights(keys.size(), 0.0f);
+		for (unsigned int index : edgeIndex) weights[index] += 1.0f;
+
+		// Start known edges from their kept polylines if at least half are known, else run every cycle from straight edges
+		std::vector<std::ptrdiff_t> kept(keys.size(), -1);
+		std::size_t known = 0;
+		for (std::size_t e = 0; e < keys.size(); ++e)
+		{
+			auto match = std::lower_bound(bundledKeys.begin(), bundledKeys.end(), keys[e]);
+			if (match == bundledKeys.end() || *match != keys[e]) continue;
+			kept[e] = match - bundledKeys.begin();
+			++known;
+		}
+		unsigned int firstCycle = (known > 0 && 2 * known >= keys.size()) ? cycles - 1 : 0;
+
+		std::size_t stride = 2 * (innerCount(firstCycle) + 2);
+		std::vector<GLfloat> start(keys.size() * stride);
+		for (std::size_t e = 0; e < keys.size(); ++e)
+		{
+			if (firstCycle > 0 && kept[e] >= 0)
+			{
+				std::copy(&polylines[kept[e] * stride], &polylines[kept[e] * stride] + stride, &start[e * stride]);
+			}
+			else
+			{
+				subdivide(unpack(keys[e]), innerCount(firstCycle), &start[e * stride]);
+			}
+		}
+
+		run(keys, weights, firstCycle, &start);
+		polylines.swap(start);
+		bundledKeys.swap(keys);
+	}
+
+	// Points of every bundled polyline, ends included
+	std::size_t pointCount() const { return innerCount(cycles - 1) + 2; }
+
+	// Points of the bundled polyline of an edge of the last set, as x, y pairs from its start to its end
+	const GLfloat* polyline(std::size_t edge) const { return &polylines[edgeIndex[edge] * 2 * pointCount()]; }
+
+private:
+
+	// Offset and bits of a snapped coordinate in a key, allowing ends somewhat off the window
+	static const int coordinateOffset = 1024;
+	static const int coordinateBits = 16;
+
+	// Pack the snapped ends of an edge into a sortable key
+	static std::uint64_t key(const Edge& edge)
+	{
+		std::uint64_t packed = 0;
+		for (GLfloat coordinate : { edge.x0, edge.y0, edge.x1, edge.y1 })
+		{
+			int snapped = (int)std::floor(coordinate + 0.5f) + coordinateOffset;
+			snapped = std::min(std::max(snapped, 0), (1 << coordinateBits) - 1);
+			packed = (packed << coordinateBits) | (std::uint64_t)snapped;
+		}
+		return packed;
+	}
+
+	// Snapped edge of a key
+	static Edge unpack(std::uint64_t packed)
+	{
+		const std::uint64_t mask = (1 << coordinateBits) - 1;
+		Edge edge{};
+		edge.y1 = (GLfloat)((int)(packed & mask) - coordinateOffset);
+		edge.x1 = (GLfloat)((int)((packed >> coordinateBits) & mask) - coordinateOffset);
+		edge.y0 = (GLfloat)((int)((packed >> (2 * coordinateBits)) & mask) - coordinateOffset);
+		edge.x0 = (GLfloat)((int)((packed >> (3 * coordinateBits)) & mask) - coordinateOffset);
+		return edge;
+	}
+
+	// Inner points of a polyline in a cycle: 1, 3, 7, ...
+	static unsigned int innerCount(unsigned int cycle) { return (2u << cycle) - 1; }
+
+	// Evenly spaced points of a straight edge, ends included
+	static void subdivide(const Edge& edge, unsigned int inner, GLfloat* points)
+	{
+		for (unsigned int i = 0; i <= inner + 1; ++i)
+		{
+			GLfloat t = (GLfloat)i / (inner + 1);
+			points[2 * i] = edge.x0 + t * (edge.x1 - edge.x0);
+			points[2 * i + 1] = edge.y0 + t * (edge.y1 - edge.y0);
+		}
+	}
+
+	// Compatible edge, the strength of its pull and whether it runs the other way
+	struct Neighbor {
+		unsigned int edge;
+		GLfloat strength;
+		bool reversed;
+	};
+
+	// Find the compatible edges of every edge, looking only in the grid cells around its midpoint
+	std::vector<std::vector<Neighbor>> neighbors(const std::vector<Edge>& edges, const std::vector<GLfloat>& weights) const
+	{
+		// Position compatibility falls below the threshold past this midpoint distance for every pair
+		GLfloat longest = 0.0f;
+		for (const Edge& edge : edges) longest = std::max(longest, length(edge));
+		GLfloat cellSize = std::max(1.0f, longest * (1.0f - threshold) / threshold);
+
+		GLfloat minX = 0.0f, minY = 0.0f;
+		for (std::size_t e = 0; e < edges.size(); ++e)
+		{
+			minX = (e == 0) ? midX(edges[e]) : std::min(minX, midX(edges[e]));
+			minY = (e == 0) ? midY(edges[e]) : std::min(minY, midY(edges[e]));
+		}
+		std::vector<std::pair<std::uint64_t, unsigned int>> cells(edges.size());
+		for (std::size_t e = 0; e < edges.size(); ++e) cells[e] = { cell(cellX(edges[e], minX, cellSize), cellY(edges[e], minY, cellSize)), (unsigned int)e };
+		std::sort(cells.begin(), cells.end());
+
+		std::vector<std::vector<Neighbor>> result(edges.size());
+		parallelFor(edges.size(), [&](std::size_t begin, std::size_t end, unsigned int)
+		{
+			for (std::size_t p = begin; p < end; ++p)
+			{
+				int column = cellX(edges[p], minX, cellSize);
+				int row = cellY(edges[p], minY, cellSize);
+				for (int dy = -1; dy <= 1; ++dy)
+				{
+					for (int dx = -1; dx <= 1; ++dx)
+					{
+						if (column + dx < 0 || row + dy < 0) continue;
+						std::uint64_t target = cell(column + dx, row + dy);
+						auto first = std::lower_bound(cells.begin(), cells.end(), std::make_pair(target, 0u));
+						for (auto it = first; it != cells.end() && it->first == target; ++it)
+						{
+							if (it->second == p) continue;
+							GLfloat c = compatibility(edges[p], edges[it->second]);
+							if (c < threshold) continue;
+							bool reversed = (edges[p].x1 - edges[p].x0) * (edges[it->second].x1 - edges[it->second].x0)
+								+ (edges[p].y1 - edges[p].y0) * (edges[it->second].y1 - edges[it->second].y0) < 0.0f;
+							result[p].push_back({ it->second, c * weights[it->second], reversed });
+						}
+					}
+				}
+
+				// Keep the strongest pulls, as shares of their sum
+				std::vector<Neighbor>& pulls = result[p];
+				std::size_t kept = std::min<std::size_t>(pulls.size(), maxNeighbors);
+				std::partial_sort(pulls.begin(), pulls.begin() + kept, pulls.end(),
+					[](const Neighbor& lhs, const Neighbor& rhs) { return lhs.strength > rhs.strength; });
+				pulls.resize(kept);
+				GLfloat total = 0.0f;
+				for (const Neighbor& pull : pulls) total += pull.strength;
+				for (Neighbor& pull : pulls) pull.strength /= total;
+			}
+		});
+		return result;
+	}
+
+	// Run the cycles from the first given one, with the polylines starting at the given points
+	void run(const std::vector<std::uint64_t>& keys, const std::vector<GLfloat>& weights, unsigned int firstCycle, std::vector<GLfloat>* points) const
+	{
+		std::vector<Edge> edges(keys.size());
+		GLfloat meanLength = 0.0f;
+		for (std::size_t e = 0; e < keys.size(); ++e)
+		{
+			edges[e] = unpack(keys[e]);
+			meanLength += length(edges[e]) / keys.size();
+		}
+		std::vector<std::vector<Neighbor>> compatible = neighbors(edges, weights);
+
+		GLfloat step = 0.1f * meanLength;
+		unsigned int cycleIterations = iterations;
+		for (unsigned int c = 0; c < firstCycle; ++c)
+		{
+			step /= 2;
+			cycleIterations = cycleIterations * 2 / 3;
+		}
+
+		std::vector<GLfloat> next{};
+		for (unsigned int c = firstCycle; c < cycles; ++c)
+		{
+			unsigned int inner = innerCount(c);
+			std::size_t stride = 2 * (inner + 2);
+			for (unsigned int iteration = 0; iteration < cycleIterations; ++iteration)
+			{
+				next = *points;
+				parallelFor(edges.size(), [&](std::size_t begin, std::size_t end, unsigned int)
+				{
+					for (std::size_t p = begin; p < end; ++p)
+					{
+						const GLfloat* current = &(*points)[p * stride];
+						GLfloat spring = stiffness * (inner + 1) / std::max(length(edges[p]), 1.0f);
+						for (unsigned int i = 1; i <= inner; ++i)
+						{
+							GLfloat x = current[2 * i];
+							GLfloat y = current[2 * i + 1];
+							GLfloat forceX = spring * (current[2 * i - 2] + current[2 * i + 2] - 2 * x);
+							GLfloat forceY = spring * (current[2 * i - 1] + current[2 * i + 3] - 2 * y);
+							for (const Neighbor& neighbor : compatible[p])
+							{
+								unsigned int j = neighbor.reversed ? inner + 1 - i : i;
+								const GLfloat* other = &(*points)[neighbor.edge * stride + 2 * j];
+								GLfloat dx = other[0] - x;
+								GLfloat dy = other[1] - y;
+								GLfloat distance = std::sqrt(dx * dx + dy * dy);
+								GLfloat reach = std::max(distance, step);	// pull nearer points only part of the way
+								forceX += neighbor.strength * dx / reach;
+								forceY += neighbor.strength * dy / reach;
+							}
+							next[p * stride + 2 * i] = x + step * forceX;
+							next[p * stride + 2 * i + 1] = y + step * forceY;
+						}
+					}
+				});
+				points->swap(next);
+			}
+
+			// Double the points for the next cycle by adding the midpoint of every segment
+			if (c + 1 < cycles)
+			{
+				std::size_t nextStride = 2 * (innerCount(c + 1) + 2);
+				next.assign(edges.size() * nextStride, 0.0f);
+				for (std::size_t p = 0; p < edges.size(); ++p)
+				{
+					const GLfloat* current = &(*points)[p * stride];
+					GLfloat* refined = &next[p * nextStride];
+					for (unsigned int i = 0; i <= inner; ++i)
+					{
+						refined[4 * i] = current[2 * i];
+						refined[4 * i + 1] = current[2 * i + 1];
+						refined[4 * i + 2] = (current[2 * i] + current[2 * i + 2]) / 2;
+						refined[4 * i + 3] = (current[2 * i + 1] + current[2 * i + 3]) / 2;
+					}
+					refined[nextStride - 2] = current[stride - 2];
+					refined[nextStride - 1] = current[stride - 1];
+				}
+				points->swap(next);
+				step /= 2;
+				cycleIterations = cycleIterations * 2 / 3;
+			}
+		}
+	}
+
+	// Product of the angle, scale, position and visibility compatibilities of two edges, in [0, 1]
+	static GLfloat compatibility(const Edge& p, const Edge& q)
+	{
+		GLfloat lengthP = length(p);
+		GLfloat lengthQ = length(q);
+		if (lengthP < 1e-3f || lengthQ < 1e-3f) return 0.0f;
+
+		GLfloat angle = std::fabs(((p.x1 - p.x0) * (q.x1 - q.x0) + (p.y1 - p.y0) * (q.y1 - q.y0)) / (lengthP * lengthQ));
+		GLfloat average = (lengthP + lengthQ) / 2;
+		GLfloat scale = 2.0f / (average / std::min(lengthP, lengthQ) + std::max(lengthP, lengthQ) / average);
+		GLfloat midDistance = std::hypot(midX(p) - midX(q), midY(p) - midY(q));
+		GLfloat position = average / (average + midDistance);
+		return angle * scale * position * std::min(visibility(p, q), visibility(q, p));
+	}
+
+	// How much of q, projected onto the line of p, falls on p
+	static GLfloat visibility(const Edge& p, const Edge& q)
+	{
+		GLfloat dx = p.x1 - p.x0;
+		GLfloat dy = p.y1 - p.y0;
+		GLfloat squared = dx * dx + dy * dy;
+		GLfloat t0 = ((q.x0 - p.x0) * dx + (q.y0 - p.y0) * dy) / squared;
+		GLfloat t1 = ((q.x1 - p.x0) * dx + (q.y1 - p.y0) * dy) / squared;
+		GLfloat midT = (t0 + t1) / 2;
+		GLfloat spread = std::fabs(t1 - t0);
+		if (spread < 1e-6f) return (midT >= 0.0f && midT <= 1.0f) ? 1.0f : 0.0f;
+		return std::max(0.0f, 1.0f - 2.0f * std::fabs(midT - 0.5f) / spread);
+	}
+
+	static GLfloat length(const Edge& edge) { return std::hypot(edge.x1 - edge.x0, edge.y1 - edge.y0); }
+	static GLfloat midX(const Edge& edge) { return (edge.x0 + edge.x1) / 2; }
+	static GLfloat midY(const Edge& edge) { return (edge.y0 + edge.y1) / 2; }
+	static int cellX(const Edge& edge, GLfloat minX, GLfloat size) { return (int)((midX(edge) - minX) / size); }
+	static int cellY(const Edge& edge, GLfloat minY, GLfloat size) { return (int)((midY(edge) - minY) / size); }
+	static std::uint64_t cell(int column, int row) { return ((std::uint64_t)(std::uint32_t)row << 32) | (std::uint32_t)column; }
+
+	unsigned int cycles;						// refinement cycles
+	unsigned int iterations;					// iterations of the first cycle
+	GLfloat stiffness;							// spring constant along each edge
+	GLfloat threshold;							// least compatibility of attracting edges
+	unsigned int maxNeighbors;					// most compatible edges pulling each edge
+	std::vector<std::uint64_t> bundledKeys{};	// snapped edges bundled last, sorted
+	std::vector<GLfloat> polylines{};			// bundled polyline of each of them, x, y pairs
+	std::vector<unsigned int> edgeIndex{};		// bundled edge of each edge of the last set
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include "GL/glut.h"
+#ifndef _WIN32
+#include <GL/glx.h>
+#endif
+
+// GL 3.3 enums missing from the GL 1.1 headers of some platforms
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+#ifndef GL_CLIP_DISTANCE0
+#define GL_CLIP_DISTANCE0 0x3000
+#endif
+
+/* GLCore: entry points of the GL 3.3 shader, buffer and instancing API
+*  Only GL 1.1 can be linked against on every platform, so these are
+*  looked up at run time through wglGetProcAddress on Windows and
+*  glXGetProcAddressARB elsewhere. Load once a context is current;
+*  if the context is older than GL 3.3 or any entry point is
+*  missing, it cannot run the shader-based renderers. The version
+*  is checked first because glXGetProcAddressARB returns a pointer
+*  for any name on Mesa and glvnd, supported or not.
+*/
+struct GLCore {
+	GLuint (APIENTRY* createShader)(GLenum type) = nullptr;
+	void (APIENTRY* shaderSource)(GLuint shader, GLsizei count, const char* const* source, const GLint* length) = nullptr;
+	void (APIENTRY* compileShader)(GLuint shader) = nullptr;
+	void (APIENTRY* getShaderiv)(GLuint shader, GLenum name, GLint* value) = nullptr;
+	void (APIENTRY* getShaderInfoLog)(GLuint shader, GLsizei size, GLsizei* length, char* log) = nullptr;
+	void (APIENTRY* deleteShader)(GLuint shader) = nullptr;
+	GLuint (APIENTRY* createProgram)() = nullptr;
+	void (APIENTRY* attachShader)(GLuint program, GLuint shader) = nullptr;
+	void (APIENTRY* linkProgram)(GLuint program) = nullptr;
+	void (APIENTRY* getProgramiv)(GLuint program, GLenum name, GLint* value) = nullptr;
+	void (APIENTRY* getProgramInfoLog)(GLuint program, GLsizei size, GLsizei* length, char* log) = nullptr;
+	void (APIENTRY* useProgram)(GLuint program) = nullptr;
+	GLint (APIENTRY* getUniformLocation)(GLuint program, const char* name) = nullptr;
+	void (APIENTRY* uniform1i)(GLint location, GLint value) = nullptr;
+	void (APIENTRY* uniform1f)(GLint location, GLfloat value) = nullptr;
+	void (APIENTRY* uniform2f)(GLint location, GLfloat x, GLfloat y) = nullptr;
+	void (APIENTRY* uniform1fv)(GLint location, GLsizei count, const GLfloat* values) = nullptr;
+	void (APIENTRY* uniform4fv)(GLint location, GLsizei count, const GLfloat* values) = nullptr;
+	void (APIENTRY* genBuffers)(GLsizei count, GLuint* buffers) = nullptr;
+	void (APIENTRY* bindBuffer)(GLenum target, GLuint buffer) = nullptr;
+	void (APIENTRY* bufferData)(GLenum target, std::ptrdiff_t size, const void* data, GLenum usage) = nullptr;
+	void (APIENTRY* genVertexArrays)(GLsizei count, GLuint* arrays) = nullptr;
+	void (APIENTRY* bindVertexArray)(GLuint array) = nullptr;
+	void (APIENTRY* enableVertexAttribArray)(GLuint index) = nullptr;
+	void (APIENTRY* vertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset) = nullptr;
+	void (APIENTRY* vertexAttribDivisor)(GLuint index, GLuint divisor) = nullptr;
+	void (APIENTRY* drawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei instances) = nullptr;
+
+	/*
+	* load
+	* Look up every entry point in the current context.
+	*
+	* @return	true if the context is GL 3.3 or later and all of them were found
+	*/
+	bool load()
+	{
+		return hasVersion(3, 3) && loadProc(&createShader, "glCreateShader") && loadProc(&shaderSource, "glShaderSource")
+			&& loadProc(&compileShader, "glCompileShader") && loadProc(&getShaderiv, "glGetShaderiv")
+			&& loadProc(&getShaderInfoLog, "glGetShaderInfoLog") && loadProc(&deleteShader, "glDeleteShader")
+			&& loadProc(&createProgram, "glCreateProgram") && loadProc(&attachShader, "glAttachShader")
+			&& loadProc(&linkProgram, "glLinkProgram") && loadProc(&getProgramiv, "glGetProgramiv")
+			&& loadProc(&getProgramInfoLog, "glGetProgramInfoLog") && loadProc(&useProgram, "glUseProgram")
+			&& loadProc(&getUniformLocation, "glGetUniformLocation") && loadProc(&uniform1i, "glUniform1i")
+			&& loadProc(&uniform1f, "glUniform1f") && loadProc(&uniform2f, "glUniform2f")
+			&& loadProc(&uniform1fv, "glUniform1fv") && loadProc(&uniform4fv, "glUniform4fv")
+			&& loadProc(&genBuffers, "glGenBuffers") && loadProc(&bindBuffer, "glBindBuffer")
+			&& loadProc(&bufferData, "glBufferData") && loadProc(&genVertexArrays, "glGenVertexArrays")
+			&& loadProc(&bindVertexArray, "glBindVertexArray") && loadProc(&enableVertexAttribArray, "glEnableVertexAttribArray")
+			&& loadProc(&vertexAttribPointer, "glVertexAttribPointer") && loadProc(&vertexAttribDivisor, "glVertexAttribDivisor")
+			&& loadProc(&drawArraysInstanced, "glDrawArraysInstanced");
+	}
+
+private:
+
+	// Whether the current context reports at least the given GL version
+	static bool hasVersion(int major, int minor)
+	{
+		const char* version = (const char*)glGetString(GL_VERSION);
+		int contextMajor = 0, contextMinor = 0;
+		if (version == nullptr || std::sscanf(version, "%d.%d", &contextMajor, &contextMinor) != 2) return false;
+		return contextMajor > major || (contextMajor == major && contextMinor >= minor);
+	}
+
+	// Look up one entry point, returning false if the context lacks it
+	template <typename Proc>
+	static bool loadProc(Proc* proc, const char* name)
+	{
+#ifdef _WIN32
+		*proc = (Proc)wglGetProcAddress(name);
+		std::ptrdiff_t address = (std::ptrdiff_t)*proc;
+		if (address >= -1 && address <= 3) *proc = nullptr;	// some drivers return small values instead of null
+#else
+		*proc = (Proc)glXGetProcAddressARB((const GLubyte*)name);
+#endif
+		return *proc != nullptr;
+	}
+};
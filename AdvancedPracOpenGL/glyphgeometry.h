@@ -0,0 +1,212 @@
+#pragma once
+#include <vector>
+#include "GL/glut.h"
+#include "dataview.h"
+#include "glyphmapping.h"
+#include "parallel.h"
+#include "sftrig.h"
+#include "spc_sf.h"
+
+/* GlyphLayout: placement of located glyphs in the window
+*  Holds the window and scaling constants that decide where
+*  the viewports of a glyph's three located copies go.
+*/
+struct GlyphLayout {
+	int screenWidth = 0;			// window width in pixels
+	int screenHeight = 0;			// window height in pixels
+	int viewportScale = 8;			// window width over glyph viewport size
+	unsigned int widthScale = 4;	// window width over SPC plot width
+	unsigned int heightScale = 10;	// window height over top margin of the SPC plots
+
+	// Side of a glyph's viewport in pixels
+	GLfloat viewportSize() const { return (GLfloat)(screenWidth / viewportScale); }
+
+	// Offset from a viewport's lower-left corner to the end of the edges drawn from it
+	GLfloat edgeOffset() const { return (GLfloat)((screenWidth / viewportScale) - ((GLint)screenWidth / (viewportScale * 2))); }
+
+	/*
+	* anchors
+	* Locate the lower-left corners of the viewports of a glyph's three
+	* located copies, one in each of the paired coordinate axes.
+	*
+	* @param	position	positions of the glyph in the three axes (x1, y1, x2, y2, x3, y3), in [0, 1]
+	*			out			viewport corners in window pixels (x1, y1, x2, y2, x3, y3)
+	*/
+	void anchors(const GLfloat position[6], GLfloat out[6]) const
+	{
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			out[2 * k] = ((screenWidth / widthScale) * position[2 * k]) + ((k * screenWidth) / 3) - ((GLint)screenWidth / (viewportScale * 2));
+			out[2 * k + 1] = ((screenHeight - (screenHeight / heightScale)) * position[2 * k + 1]) - ((GLint)screenWidth / (viewportScale * 2));
+		}
+	}
+};
+
+/* GlyphGeometry: located glyph geometry of many rows, as arrays
+*  For every row, holds the viewport corners of its three located
+*  copies, the ends of the edges joining them, the end points of
+*  its two SF segments and the centers of its three SPC crosses.
+*  Segment ends and cross centers are in the glyph's viewport
+*  coordinates; corners and edge ends are in window pixels. Each
+*  quantity is its own array indexed by row, and the arrays keep
+*  their storage between frames. Rows are traced in parallel
+*  without any GL calls, following the same turns and moves as
+*  SpcSfGlyph::traceGlyphSF. The sines and cosines of the SF
+*  angles come from a table when the data values are quantized,
+*  and from a batched polynomial otherwise.
+*/
+struct GlyphGeometry {
+	std::size_t numRows = 0;
+	std::vector<GLfloat> anchorX[3], anchorY[3];	// viewport corner in each SPC plot
+	std::vector<GLfloat> edgeX[3], edgeY[3];		// edge end in each SPC plot
+	std::vector<GLfloat> pos2X, pos2Y;				// end of the first SF segment
+	std::vector<GLfloat> pos3X, pos3Y;				// end of the second SF segment
+	std::vector<GLfloat> crossX[3], crossY[3];		// center of each SPC cross
+
+	/*
+	* compute
+	* Trace the located glyphs of the selected rows.
+	*
+	* @param	data			view of the rows to trace
+	*			mapping			columns read by each glyph channel
+	*			layout			placement of the glyph viewports
+	*			dynamicAngles	turn the second segment relative to the first
+	*			posAngle		turn the first segment up instead of down
+	*			angleFocus		encode angles (true) or lengths (false) with the first two stick attributes
+	*/
+	void compute(const DataView& data, const GlyphMapping& mapping, const GlyphLayout& layout,
+		bool dynamicAngles, bool posAngle, bool angleFocus)
+	{
+		resize(data.size());
+		GLfloat edgeOffset = layout.edgeOffset();
+		AngleMap angles(R_MIN, R_MAX, T_MIN, T_MAX);
+		SinCosTable table(angles, RADIAN_PER_DEGREE);
+
+		parallelFor(numRows, [&](std::size_t begin, std::size_t end, unsigned int)
+		{
+			traceSegments(data, mapping, angles, table, begin, end, dynamicAngles, posAngle, angleFocus);
+
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				RowView row = data[i];
+				GLfloat position[6], anchors[6], axes[6];
+				mapping.positions(row, position);
+				mapping.spcAxes(row, axes);
+				layout.anchors(position, anchors);
+
+				// Crosses sit at the origin and the two segment ends, shifted by the SPC axes
+				crossX[0][i] = -axes[0];
+				crossY[0][i] = -axes[1];
+				crossX[1][i] = pos2X[i] - axes[2];
+				crossY[1][i] = pos2Y[i] - axes[3];
+				crossX[2][i] = pos3X[i] - axes[4];
+				crossY[2][i] = pos3Y[i] - axes[5];
+
+				for (std::size_t k = 0; k < 3; ++k)
+				{
+					anchorX[k][i] = anchors[2 * k];
+					anchorY[k][i] = anchors[2 * k + 1];
+					edgeX[k][i] = anchors[2 * k] + edgeOffset;
+					edgeY[k][i] = anchors[2 * k + 1] + edgeOffset;
+				}
+			}
+		});
+	}
+
+private:
+
+	// Trace the two SF segments of rows [begin, end) into the segment end arrays
+	void traceSegments(const DataView& data, const GlyphMapping& mapping, const AngleMap& angles, const SinCosTable& table,
+		std::size_t begin, std::size_t end, bool dynamicAngles, bool posAngle, bool angleFocus)
+	{
+		const std::size_t blockSize = 256;
+		GLfloat sign = posAngle ? 1.0f : -1.0f;		// first segment turns up or down
+
+		// Rows of a block whose values are off the table's grid, with the heading in radians
+		// and the length of each of their segments
+		std::size_t pending[blockSize];
+		GLfloat headings[2 * blockSize], lengths[2 * blockSize];
+		GLfloat sines[2 * blockSize], cosines[2 * blockSize];
+		std::size_t numPending = 0;
+
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			GLfloat stick[4];
+			mapping.stickFigure(data[i], stick);
+
+			// Angle and length of each segment, as chosen by ANGLE_FOCUS
+			GLfloat ang1 = angleFocus ? stick[0] : stick[3];
+			GLfloat dist1 = angleFocus ? stick[1] : stick[2];
+			GLfloat ang2 = angleFocus ? stick[2] : stick[1];
+			GLfloat dist2 = angleFocus ? stick[3] : stick[0];
+
+			int index1 = table.index(ang1);
+			int index2 = table.index(ang2);
+			if (index1 < 0 || index2 < 0)
+			{
+				GLfloat heading1 = sign * angles.degrees(ang1);
+				GLfloat heading2 = dynamicAngles ? heading1 + angles.degrees(ang2) : angles.degrees(ang2);
+				headings[2 * numPending] = RADIAN_PER_DEGREE * heading1;
+				headings[2 * numPending + 1] = RADIAN_PER_DEGREE * heading2;
+				lengths[2 * numPending] = dist1;
+				lengths[2 * numPending + 1] = dist2;
+				pending[numPending++] = i;
+			}
+			else
+			{
+
+				GLfloat sin1 = sign * table.sine(index1);
+				GLfloat cos1 = table.cosine(index1);
+				GLfloat sin2 = table.sine(index2);
+				GLfloat cos2 = table.cosine(index2);
+				if (dynamicAngles)
+				{	// Second heading is relative to the first: rotate by the first angle
+					GLfloat sinSum = sin1 * cos2 + cos1 * sin2;
+					cos2 = cos1 * cos2 - sin1 * sin2;
+					sin2 = sinSum;
+				}
+				setSegments(i, dist1 * cos1, dist1 * sin1, dist2 * cos2, dist2 * sin2);
+			}
+
+			// Evaluate the pending headings together once the block is full or the range ends
+			if (numPending == blockSize || (i + 1 == end && numPending > 0))
+			{
+				sinCosBatch(headings, 2 * numPending, sines, cosines);
+				for (std::size_t p = 0; p < numPending; ++p)
+				{
+					setSegments(pending[p], lengths[2 * p] * cosines[2 * p], lengths[2 * p] * sines[2 * p],
+						lengths[2 * p + 1] * cosines[2 * p + 1], lengths[2 * p + 1] * sines[2 * p + 1]);
+				}
+				numPending = 0;
+			}
+		}
+	}
+
+	// Store the segment ends of a row from the two segment vectors
+	void setSegments(std::size_t i, GLfloat dx1, GLfloat dy1, GLfloat dx2, GLfloat dy2)
+	{
+		pos2X[i] = dx1;
+		pos2Y[i] = dy1;
+		pos3X[i] = dx1 + dx2;
+		pos3Y[i] = dy1 + dy2;
+	}
+
+	// Size every array for the given number of rows, reusing their storage
+	void resize(std::size_t rows)
+	{
+		numRows = rows;
+		for (std::size_t k = 0; k < 3; ++k)
+		{
+			anchorX[k].resize(rows);
+			anchorY[k].resize(rows);
+			edgeX[k].resize(rows);
+			edgeY[k].resize(rows);
+			crossX[k].resize(rows);
+			crossY[k].resize(rows);
+		}
+		pos2X.resize(rows);
+		pos2Y.resize(rows);
+		pos3X.resize(rows);
+		pos3Y.resize(rows);
+	}
+};
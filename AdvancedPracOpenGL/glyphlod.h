@@ -0,0 +1,130 @@
+#pragma once
+#include <cstddef>
+#include "GL/glut.h"
+
+// Level of detail of located glyphs, from most to least detailed
+enum class GlyphDetail : unsigned int {
+	Full = 0,	// SF bird with SPC crosses
+	Bird = 1,	// SF bird only
+	Edge = 2,	// edges between the located copies only
+	Point = 3	// one point per glyph
+};
+
+/* GlyphLevelOfDetail: picks how much of each located glyph to draw
+*  The glyph's size on screen sets the most detailed tier worth
+*  drawing: crosses are unreadable in small viewports, and birds in
+*  tiny ones. The time spent drawing the previous frames, per glyph
+*  and per tier, then sets the most detailed tier that fits the
+*  frame budget for the current number of glyphs. Tiers never
+*  measured are estimated from a measured one by their relative
+*  cost. A finer tier is only taken back with some headroom, so the
+*  choice does not flicker between two tiers, and the next finer
+*  tier is probed for one frame whenever its measurement has gone
+*  stale, so a few slow frames or a pessimistic estimate do not rule
+*  it out for good. Stale measurements are dropped in favor of an
+*  estimate from the current tier.
+*/
+class GlyphLevelOfDetail {
+public:
+	/*
+	* GlyphLevelOfDetail
+	* Constructor.
+	*
+	* @param	budget		milliseconds allowed for drawing the glyphs of a frame
+	*			birdSize	smallest viewport side in pixels that shows SPC crosses
+	*			pointSize	smallest viewport side in pixels that shows birds
+	*/
+	GlyphLevelOfDetail(double budget = 50.0, GLfloat birdSize = 24.0, GLfloat pointSize = 6.0)
+		: budget(budget), birdSize(birdSize), pointSize(pointSize) {}
+
+	/*
+	* select
+	* Pick the tier of the next frame.
+	*
+	* @param	glyphSize	side of a glyph's viewport in pixels
+	*			count		number of glyphs to draw
+	* @return				the tier to draw
+	*/
+	GlyphDetail select(GLfloat glyphSize, std::size_t count)
+	{
+		unsigned int finest = (glyphSize < pointSize) ? tier(GlyphDetail::Point)
+			: ((glyphSize < birdSize) ? tier(GlyphDetail::Bird) : tier(GlyphDetail::Full));
+
+		unsigned int chosen = tier(GlyphDetail::Point);
+		for (unsigned int t = finest; t < numTiers; ++t)
+		{
+			double estimate = estimateCost(t) * count;
+			double allowed = (t < tier(detail)) ? budget * headroom : budget;	// finer than now needs headroom
+			if (estimate <= allowed)
+			{
+				chosen = t;
+				break;
+			}
+		}
+
+		// Probe the next finer tier if its measurement is stale and it may plausibly fit
+		if (chosen > finest && ages[chosen - 1] >= maxAge && estimateCost(chosen - 1) * count <= budget * probeLimit) --chosen;
+
+		detail = (GlyphDetail)chosen;
+		return detail;
+	}
+
+	/*
+	* record
+	* Take the time spent drawing the glyphs of the frame just drawn
+	* at the selected tier, and age the measurements of the others.
+	*
+	* @param	milliseconds	drawing time of the frame's glyphs alone
+	*			count			number of glyphs drawn
+	*/
+	void record(double milliseconds, std::size_t count)
+	{
+		if (count == 0) return;
+		double perGlyph = milliseconds / count;
+		unsigned int current = tier(detail);
+		for (unsigned int t = 0; t < numTiers; ++t)
+		{
+			if (t == current || ages[t] == maxAge) continue;
+			if (++ages[t] == maxAge) costs[t] = 0.0;	// stale: estimate it from a fresh tier until probed again
+		}
+
+		double& cost = costs[current];
+		cost = (cost > 0.0) ? (cost + perGlyph) / 2 : perGlyph;		// smooth over frames
+		ages[current] = 0;
+	}
+
+	// Tier selected for the current frame
+	GlyphDetail getDetail() const { return detail; }
+
+	// Set the milliseconds allowed for drawing the glyphs of a frame
+	void setBudget(double milliseconds) { budget = milliseconds; }
+
+private:
+
+	static unsigned int tier(GlyphDetail d) { return (unsigned int)d; }
+
+	// Milliseconds per glyph of a tier, measured or estimated from the nearest measured tier (0 if none is)
+	double estimateCost(unsigned int t) const
+	{
+		if (costs[t] > 0.0) return costs[t];
+		for (unsigned int distance = 1; distance < numTiers; ++distance)
+		{
+			if (t >= distance && costs[t - distance] > 0.0) return costs[t - distance] * weights[t] / weights[t - distance];
+			if (t + distance < numTiers && costs[t + distance] > 0.0) return costs[t + distance] * weights[t] / weights[t + distance];
+		}
+		return 0.0;
+	}
+
+	static const unsigned int numTiers = 4;
+	const double weights[numTiers] = { 1.0, 0.4, 0.2, 0.05 };	// rough relative cost of each tier
+	const double headroom = 0.7;		// share of the budget a finer tier must fit in to be taken back
+	const unsigned int maxAge = 120;	// frames after which a tier's measurement is stale
+	const double probeLimit = 2.0;		// budgets a stale tier's estimate may take to still be probed
+
+	double budget;						// milliseconds allowed per frame
+	GLfloat birdSize;					// smallest viewport side showing crosses
+	GLfloat pointSize;					// smallest viewport side showing birds
+	double costs[numTiers] = { 0.0, 0.0, 0.0, 0.0 };	// measured milliseconds per glyph of each tier
+	unsigned int ages[numTiers] = { maxAge, maxAge, maxAge, maxAge };	// frames since each tier was last measured
+	GlyphDetail detail = GlyphDetail::Full;				// tier of the current frame
+};
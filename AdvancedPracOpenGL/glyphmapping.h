@@ -0,0 +1,116 @@
+#pragma once
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include "GL/glut.h"
+#include "dataview.h"
+
+/* GlyphMapping: assignment of data set columns to glyph channels
+*  Each channel of an SPC-SF glyph reads one column of the data
+*  point, and a column may feed several channels. Channels read
+*  the row in place, so data sets with fewer columns than the
+*  glyph has channels are drawn by mapping columns to several
+*  channels instead of copying attributes into a wider row.
+*/
+struct GlyphMapping {
+	unsigned int spc[6];		// SPC axes: x1, y1, x2, y2, x3, y3
+	unsigned int stick[4];		// SF stick figure: angle 1, length 1, angle 2, length 2
+	unsigned int position[6];	// located glyph positions: x1, y1, x2, y2, x3, y3
+	unsigned int color[6];		// SF wing colors: r, g, b of first and of second segment
+
+	// Default mapping of the WBC attributes
+	static GlyphMapping wbc()
+	{
+		return GlyphMapping{
+			{ 3, 2, 3, 4, 8, 7 },	// (MA, UCsh) (MA, SIN) (MIT, NN)
+			{ 0, 1, 5, 6 },			// CL (angle), UC (length), BN (angle), BC (length)
+			{ 0, 5, 1, 6, 5, 2 },	// (CL, BN) (UCsz, BC) (BN, UCsh)
+			{ 2, 1, 0, 2, 7, 6 }
+		};
+	}
+
+	// Read the SPC axes of a row
+	void spcAxes(RowView row, GLfloat out[6]) const { gather(row, spc, 6, out); }
+
+	// Read the stick figure of a row
+	void stickFigure(RowView row, GLfloat out[4]) const { gather(row, stick, 4, out); }
+
+	// Read the located glyph positions of a row
+	void positions(RowView row, GLfloat out[6]) const { gather(row, position, 6, out); }
+
+	// Read the wing colors of a row
+	void colors(RowView row, GLfloat out[6]) const { gather(row, color, 6, out); }
+
+	/*
+	* parse
+	* Set one channel group from a comma-separated list of columns.
+	* The channel group is left unchanged if any column is not a
+	* whole number below the dimension of the data set.
+	*
+	* @param	channel		SPC, SF, POSITION or COLOR
+	*			columns		comma-separated column indices
+	*			dimension	number of columns of the data set
+	* @return	true if the channel group was recognized and fully and validly given
+	*/
+	bool parse(const std::string& channel, const std::string& columns, std::size_t dimension)
+	{
+		unsigned int* target = nullptr;
+		std::size_t count = 0;
+		if (channel == "SPC")				{ target = spc; count = 6; }
+		else if (channel == "SF")			{ target = stick; count = 4; }
+		else if (channel == "POSITION")		{ target = position; count = 6; }
+		else if (channel == "COLOR")		{ target = color; count = 6; }
+		if (target == nullptr) return false;
+
+		unsigned int parsed[6];
+		std::size_t found = 0;
+		std::stringstream ss(columns);
+		std::string substr = "";
+		while (getline(ss, substr, ','))
+		{
+			std::istringstream sin(substr);
+			long column = -1;
+			sin >> column;
+			bool valid = !sin.fail() && (sin >> std::ws).eof() && column >= 0 && (std::size_t)column < dimension;
+			if (!valid || found == count) return false;
+			parsed[found++] = (unsigned int)column;
+		}
+		if (found != count) return false;
+
+		std::copy(parsed, parsed + count, target);
+		return true;
+	}
+
+	/*
+	* format
+	* Write one channel group as a comma-separated list of columns.
+	*
+	* @param	channel		SPC, SF, POSITION or COLOR
+	* @return	columns of the channel group, as read by parse
+	*/
+	std::string format(const std::string& channel) const
+	{
+		const unsigned int* source = color;
+		std::size_t count = 6;
+		if (channel == "SPC")				{ source = spc; }
+		else if (channel == "SF")			{ source = stick; count = 4; }
+		else if (channel == "POSITION")		{ source = position; }
+
+		std::stringstream ss;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			ss << ((i > 0) ? ", " : "") << source[i];
+		}
+		return ss.str();
+	}
+
+private:
+
+	static void gather(RowView row, const unsigned int* columns, std::size_t count, GLfloat* out)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			out[i] = row[columns[i]];
+		}
+	}
+};
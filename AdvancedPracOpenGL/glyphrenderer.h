@@ -0,0 +1,341 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <iostream>
+#include "GL/glut.h"
+#include "glcore.h"
+#include "dataview.h"
+#include "glyphmapping.h"
+#include "glyphgeometry.h"
+
+/* GlyphInstance: per-glyph attributes uploaded to the GPU (44 bytes)
+*  Holds only the glyph's own data; the two SF segments and three
+*  SPC crosses are built from it in the vertex shader.
+*/
+struct GlyphInstance {
+	GLfloat anchorX, anchorY;	// lower-left corner of the glyph's viewport in window pixels
+	GLfloat stick[4];			// SF attributes in [0, 1], in mapping order
+	GLubyte colors[8];			// RGBA of the first and second segments
+	GLushort axes[6];			// SPC cross offsets in [0, 1]
+};
+
+/* GlyphStyle: display settings of the instanced glyphs
+*  Every field becomes a shader uniform, so changing one only
+*  changes the next draw call and never the uploaded instances.
+*/
+struct GlyphStyle {
+	bool dynamicAngles = false;		// turn the second segment relative to the first
+	bool posAngle = false;			// turn the first segment up instead of down
+	bool angleFocus = true;			// encode angles (true) or lengths (false) with the first two stick attributes
+	bool birdFocus = true;			// color the segments (true) or grey them out (false)
+	bool drawAxes = true;			// draw the SPC crosses
+	bool dottedAxes = false;		// stipple the SPC crosses
+	GLfloat glyphScaleFactor = 0.25;	// scale of the SPC crosses
+	GLfloat axisLength = 1.0;		// SPC axis length
+};
+
+/* GlyphRenderer: located SPC-SF glyphs drawn with instanced shaders
+*  Each glyph is uploaded once per frame as a GlyphInstance, and one
+*  instanced draw call per primitive kind turns every instance into
+*  its segments and crosses. The vertex shader follows the turns of
+*  SpcSfGlyph::traceGlyphSF and the cross layout of drawAxesSPC, and
+*  clips each glyph to its viewport as glViewport would. Needs GLSL
+*  3.30; init reports false on contexts that cannot run it, so the
+*  caller can keep drawing through the CPU paths.
+*/
+class GlyphRenderer {
+public:
+	/*
+	* init
+	* Load the GL entry points and build the shader program. Call once
+	* a context is current.
+	*
+	* @return	true if the renderer can draw in this context
+	*/
+	bool init()
+	{
+		if (!gl.load()) return false;
+		GLuint vertexShader = compile(GL_VERTEX_SHADER, vertexSource());
+		GLuint fragmentShader = compile(GL_FRAGMENT_SHADER, fragmentSource());
+		if (vertexShader == 0 || fragmentShader == 0) return false;
+
+		program = gl.createProgram();
+		gl.attachShader(program, vertexShader);
+		gl.attachShader(program, fragmentShader);
+		gl.linkProgram(program);
+		gl.deleteShader(vertexShader);
+		gl.deleteShader(fragmentShader);
+		GLint linked = 0;
+		gl.getProgramiv(program, GL_LINK_STATUS, &linked);
+		if (!linked)
+		{
+			char log[1024] = "";
+			gl.getProgramInfoLog(program, sizeof(log), nullptr, log);
+			std::cout << "Error: Glyph shader did not link.\n" << log << "\n";
+			return false;
+		}
+
+		// One buffer of interleaved instances, read once per instance
+		gl.genVertexArrays(1, &vertexArray);
+		gl.genBuffers(1, &buffer);
+		gl.bindVertexArray(vertexArray);
+		gl.bindBuffer(GL_ARRAY_BUFFER, buffer);
+		attribute(0, 2, GL_FLOAT, GL_FALSE, offsetof(GlyphInstance, anchorX));
+		attribute(1, 4, GL_FLOAT, GL_FALSE, offsetof(GlyphInstance, stick));
+		attribute(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(GlyphInstance, colors));
+		attribute(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(GlyphInstance, colors) + 4);
+		for (GLuint k = 0; k < 3; ++k)
+		{
+			attribute(4 + k, 2, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(GlyphInstance, axes) + 4 * k);
+		}
+		gl.bindVertexArray(0);
+		gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+
+		ready = true;
+		return true;
+	}
+
+	// Whether init succeeded
+	bool isReady() const { return ready; }
+
+	/*
+	* upload
+	* Fill the instance buffer with the glyphs of the selected rows,
+	* placed at one of their three located copies.
+	*
+	* @param	data		view of the rows, as traced into geometry
+	*			mapping		columns read by each glyph channel
+	*			geometry	traced geometry of the rows
+	*			copy		located copy to draw (0, 1 or 2)
+	*/
+	void upload(const DataView& data, const GlyphMapping& mapping, const GlyphGeometry& geometry, std::size_t copy)
+	{
+		instances.resize(data.size());
+		for (std::size_t i = 0; i < data.size(); ++i)
+		{
+			RowView row = data[i];
+			GlyphInstance& instance = instances[i];
+			instance.anchorX = geometry.anchorX[copy][i];
+			instance.anchorY = geometry.anchorY[copy][i];
+			mapping.stickFigure(row, instance.stick);
+
+			// Segment colors, rounded down when too light to see as drawLocatedGlyphs does
+			float colors[6];
+			mapping.colors(row, colors);
+			for (unsigned int c = 0; c < 6; ++c)
+			{
+				if (colors[c] > 0.8) colors[c] = colors[c] - 0.1;
+				instance.colors[c + c / 3] = toByte(colors[c]);
+			}
+			instance.colors[3] = 255;
+			instance.colors[7] = toByte(0.7f);
+
+			GLfloat axes[6];
+			mapping.spcAxes(row, axes);
+			for (unsigned int k = 0; k < 6; ++k) instance.axes[k] = toShort(axes[k]);
+		}
+
+		gl.bindBuffer(GL_ARRAY_BUFFER, buffer);
+		gl.bufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(GlyphInstance),
+			instances.empty() ? nullptr : &instances[0], GL_STREAM_DRAW);
+		gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	/*
+	* draw
+	* Draw the uploaded glyphs, SPC crosses first and SF segments on
+	* top, with the current blending state.
+	*
+	* @param	layout		placement of the glyph viewports
+	*			style		display settings
+	*/
+	void draw(const GlyphLayout& layout, const GlyphStyle& style)
+	{
+		if (!ready || instances.empty()) return;
+
+		gl.useProgram(program);
+		gl.uniform2f(location("window"), (GLfloat)layout.screenWidth, (GLfloat)layout.screenHeight);
+		gl.uniform1f(location("viewportSize"), layout.viewportSize());
+		gl.uniform1i(location("dynamicAngles"), style.dynamicAngles);
+		gl.uniform1i(location("posAngle"), style.posAngle);
+		gl.uniform1i(location("angleFocus"), style.angleFocus);
+		gl.uniform1i(location("birdFocus"), style.birdFocus);
+		gl.uniform1i(location("dottedAxes"), style.dottedAxes);
+
+		AngleMap angles(R_MIN, R_MAX, T_MIN, T_MAX);
+		gl.uniform2f(location("angleMap"), angles.scale, angles.offset);
+		gl.uniform1f(location("radiansPerDegree"), RADIAN_PER_DEGREE);
+
+		// Half-lengths of the crosses, as drawAxesSPC computes them
+		GLfloat scaledAxis = style.axisLength * style.glyphScaleFactor;
+		GLfloat crossHalf[3] = { (scaledAxis + CROSS_SCALE) / CROSS_REDUCE, (scaledAxis + 0.2f) / 2, (scaledAxis + 0.2f) / 2 };
+		GLfloat crossColors[12] = {
+			COLOR_0, COLOR_1, COLOR_0, ALPHA_CROSS,		// light green
+			0.0, 0.7, 0.0, 0.7,							// medium green
+			0.0, 0.3, 0.0, 0.7 };						// dark green
+		gl.uniform1fv(location("crossHalf"), 3, crossHalf);
+		gl.uniform1f(location("crossShift"), CROSS_SCALE_FACTOR);
+		gl.uniform4fv(location("crossColors"), 3, crossColors);
+
+		for (GLenum plane = 0; plane < 4; ++plane) glEnable(GL_CLIP_DISTANCE0 + plane);
+		gl.bindVertexArray(vertexArray);
+		if (style.drawAxes)
+		{
+			gl.uniform1i(location("part"), 1);
+			glLineWidth(2.0);
+			gl.drawArraysInstanced(GL_LINES, 0, 12, (GLsizei)instances.size());
+		}
+		gl.uniform1i(location("part"), 0);
+		glLineWidth(4.0);
+		gl.drawArraysInstanced(GL_LINES, 0, 4, (GLsizei)instances.size());
+		gl.bindVertexArray(0);
+		for (GLenum plane = 0; plane < 4; ++plane) glDisable(GL_CLIP_DISTANCE0 + plane);
+		gl.useProgram(0);
+	}
+
+	// Number of uploaded glyphs
+	std::size_t size() const { return instances.size(); }
+
+private:
+
+	// Source of the vertex shader: vertex gl_VertexID of an instance's segments or crosses
+	static const char* vertexSource()
+	{
+		return R"(#version 330 core
+layout(location = 0) in vec2 anchor;
+layout(location = 1) in vec4 stick;
+layout(location = 2) in vec4 color1;
+layout(location = 3) in vec4 color2;
+layout(location = 4) in vec2 axes1;
+layout(location = 5) in vec2 axes2;
+layout(location = 6) in vec2 axes3;
+
+uniform vec2 window;
+uniform float viewportSize;
+uniform int part;			// 0: SF segments, 1: SPC crosses
+uniform bool dynamicAngles, posAngle, angleFocus, birdFocus;
+uniform vec2 angleMap;		// degrees per data unit, degrees at 0
+uniform float radiansPerDegree;
+uniform float crossHalf[3];
+uniform float crossShift;
+uniform vec4 crossColors[3];
+
+out vec4 color;
+noperspective out float along;	// pixels from the start of the line
+
+void main()
+{
+	// Segment angles and lengths, as traceGlyphSF picks them
+	float ang1 = angleFocus ? stick.x : stick.w;
+	float dist1 = angleFocus ? stick.y : stick.z;
+	float ang2 = angleFocus ? stick.z : stick.y;
+	float dist2 = angleFocus ? stick.w : stick.x;
+	float heading1 = (posAngle ? 1.0 : -1.0) * (ang1 * angleMap.x + angleMap.y);
+	float heading2 = ang2 * angleMap.x + angleMap.y;
+	if (dynamicAngles) heading2 += heading1;
+	vec2 pos2 = dist1 * vec2(cos(radiansPerDegree * heading1), sin(radiansPerDegree * heading1));
+	vec2 pos3 = pos2 + dist2 * vec2(cos(radiansPerDegree * heading2), sin(radiansPerDegree * heading2));
+
+	int end = gl_VertexID % 2;
+	vec2 from, to;
+	if (part == 0)
+	{
+		bool first = gl_VertexID < 2;
+		from = first ? vec2(0.0) : pos2;
+		to = first ? pos2 : pos3;
+		color = birdFocus ? (first ? color1 : color2) : vec4(0.0, 0.0, 0.0, 0.3);
+	}
+	else
+	{
+		int crossIndex = gl_VertexID / 4;
+		vec2 center = (crossIndex == 0) ? -axes1 : ((crossIndex == 1) ? pos2 - axes2 : pos3 - axes3);
+		float halfLength = crossHalf[crossIndex];
+		if ((gl_VertexID / 2) % 2 == 0)
+		{	// vertical
+			from = vec2(center.x, center.y - halfLength + crossShift);
+			to = vec2(center.x, center.y + halfLength + crossShift);
+		}
+		else
+		{	// horizontal
+			from = vec2(center.x - halfLength + crossShift, center.y);
+			to = vec2(center.x + halfLength + crossShift, center.y);
+		}
+		color = crossColors[crossIndex];
+	}
+
+	// Glyph viewport to window pixels, clipped to the viewport
+	vec2 point = (end == 0) ? from : to;
+	vec2 corner = trunc(anchor);
+	vec2 pixel = corner + (point + 1.0) * 0.5 * viewportSize;
+	along = (end == 0) ? 0.0 : length(to - from) * 0.5 * viewportSize;
+	gl_ClipDistance[0] = 1.0 + point.x;
+	gl_ClipDistance[1] = 1.0 - point.x;
+	gl_ClipDistance[2] = 1.0 + point.y;
+	gl_ClipDistance[3] = 1.0 - point.y;
+	gl_Position = vec4(pixel / window * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+	}
+
+	// Source of the fragment shader: flat line color, stippled like glLineStipple(3, 0xAAAA)
+	static const char* fragmentSource()
+	{
+		return R"(#version 330 core
+in vec4 color;
+noperspective in float along;
+uniform int part;
+uniform bool dottedAxes;
+out vec4 fragColor;
+
+void main()
+{
+	if (part == 1 && dottedAxes && (int(along / 3.0) % 2) == 0) discard;
+	fragColor = color;
+}
+)";
+	}
+
+	// Compile one shader stage, returning 0 on failure
+	GLuint compile(GLenum type, const char* source)
+	{
+		GLuint shader = gl.createShader(type);
+		gl.shaderSource(shader, 1, &source, nullptr);
+		gl.compileShader(shader);
+		GLint compiled = 0;
+		gl.getShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+		if (!compiled)
+		{
+			char log[1024] = "";
+			gl.getShaderInfoLog(shader, sizeof(log), nullptr, log);
+			std::cout << "Error: Glyph shader did not compile.\n" << log << "\n";
+			gl.deleteShader(shader);
+			return 0;
+		}
+		return shader;
+	}
+
+	// Describe one per-instance attribute of the bound buffer
+	void attribute(GLuint index, GLint size, GLenum type, GLboolean normalized, std::size_t offset)
+	{
+		gl.enableVertexAttribArray(index);
+		gl.vertexAttribPointer(index, size, type, normalized, sizeof(GlyphInstance), (const void*)offset);
+		gl.vertexAttribDivisor(index, 1);
+	}
+
+	// Location of a uniform of the program
+	GLint location(const char* name) const { return gl.getUniformLocation(program, name); }
+
+	// Quantize a value in [0, 1] to a normalized byte
+	static GLubyte toByte(GLfloat value) { return (GLubyte)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); }
+
+	// Quantize a value in [0, 1] to a normalized short
+	static GLushort toShort(GLfloat value) { return (GLushort)(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f + 0.5f); }
+
+	GLCore gl{};							// GL 3.3 entry points
+	bool ready = false;						// init succeeded
+	GLuint program = 0;						// glyph shader program
+	GLuint vertexArray = 0;					// instance attribute layout
+	GLuint buffer = 0;						// instance buffer
+	std::vector<GlyphInstance> instances{};	// instances of the last upload
+};
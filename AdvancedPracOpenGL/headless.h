@@ -0,0 +1,278 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "GL/glut.h"
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+// Framebuffer object enums missing from the GL 1.1 headers of some platforms
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#endif
+#ifndef GL_RENDERBUFFER
+#define GL_RENDERBUFFER 0x8D41
+#endif
+#ifndef GL_RGBA8
+#define GL_RGBA8 0x8058
+#endif
+#ifndef GL_DEPTH_COMPONENT24
+#define GL_DEPTH_COMPONENT24 0x81A6
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#endif
+#ifndef GL_DEPTH_ATTACHMENT
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+
+/* HeadlessContext: an offscreen GL context for rendering without a display
+*  EGL is opened at run time, so neither it nor its headers are needed
+*  to build, and a display is looked up on the Mesa surfaceless
+*  platform first, falling back to the default display. The context
+*  is made current without a surface where the driver allows it, or
+*  with a 1x1 pbuffer otherwise, and every frame is drawn into a
+*  framebuffer object of the requested size with a color and a depth
+*  renderbuffer, so the image does not depend on a window. The same
+*  GL calls that draw into a GLUT window draw into it unchanged.
+*  Not available on Windows, where create() reports failure.
+*/
+class HeadlessContext {
+public:
+	~HeadlessContext() { destroy(); }
+
+	/*
+	* create
+	* Open a display, create a context and make it current, drawing
+	* into a framebuffer of the given size.
+	*
+	* @param	width, height	image size in pixels
+	* @return					true if the context is current
+	*/
+	bool create(int width, int height)
+	{
+#ifdef _WIN32
+		error = "headless rendering needs EGL, which is not available on Windows";
+		return false;
+#else
+		destroy();
+		this->width = width;
+		this->height = height;
+		if (!loadEgl()) return false;
+
+		display = nullptr;
+		GetPlatformDisplay getPlatformDisplay = (GetPlatformDisplay)getProcAddress("eglGetPlatformDisplayEXT");
+		if (getPlatformDisplay) display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr);
+		if (!display || !initialize(display, nullptr, nullptr))
+		{
+			display = getDisplay(nullptr);
+			if (!display || !initialize(display, nullptr, nullptr))
+			{
+				error = "no EGL display";
+				display = nullptr;
+				return false;
+			}
+		}
+
+		const std::int32_t attributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_DEPTH_SIZE, 24, EGL_NONE };
+		void* config = nullptr;
+		std::int32_t configs = 0;
+		if (!bindApi(EGL_OPENGL_API) || !chooseConfig(display, attributes, &config, 1, &configs) || configs < 1)
+		{
+			error = "no EGL config for desktop OpenGL";
+			return false;
+		}
+
+		context = createContext(display, config, nullptr, nullptr);
+		if (!context)
+		{
+			error = "EGL context not created";
+			return false;
+		}
+
+		// Surfaceless if the driver allows it, else a pbuffer only to make the context current
+		if (!makeCurrent(display, nullptr, nullptr, context))
+		{
+			const std::int32_t size[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+			surface = createPbufferSurface(display, config, size);
+			if (!surface || !makeCurrent(display, surface, surface, context))
+			{
+				error = "EGL context not made current";
+				return false;
+			}
+		}
+		return createFramebuffer();
+#endif
+	}
+
+	/*
+	* readPixels
+	* Read the framebuffer once drawing has finished.
+	*
+	* @return	three bytes per pixel, rows from the bottom up
+	*/
+	std::vector<GLubyte> readPixels() const
+	{
+		std::vector<GLubyte> rgb((std::size_t)width * height * 3);
+		glFinish();
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+		return rgb;
+	}
+
+	// Why the last create() failed
+	const std::string& getError() const { return error; }
+
+	// Release the framebuffer, context and display
+	void destroy()
+	{
+#ifndef _WIN32
+		if (!display) return;
+		if (framebuffer) deleteFramebuffers(1, &framebuffer);
+		if (renderbuffers[0]) deleteRenderbuffers(2, renderbuffers);
+		framebuffer = 0;
+		renderbuffers[0] = renderbuffers[1] = 0;
+		makeCurrent(display, nullptr, nullptr, nullptr);
+		if (context) destroyContext(display, context);
+		if (surface) destroySurface(display, surface);
+		terminate(display);
+		display = context = surface = nullptr;
+#endif
+	}
+
+private:
+	// EGL enums, so that EGL headers are not needed
+	static const std::int32_t EGL_NONE = 0x3038;
+	static const std::int32_t EGL_SURFACE_TYPE = 0x3033;
+	static const std::int32_t EGL_PBUFFER_BIT = 0x0001;
+	static const std::int32_t EGL_RENDERABLE_TYPE = 0x3040;
+	static const std::int32_t EGL_OPENGL_BIT = 0x0008;
+	static const std::int32_t EGL_RED_SIZE = 0x3024;
+	static const std::int32_t EGL_GREEN_SIZE = 0x3023;
+	static const std::int32_t EGL_BLUE_SIZE = 0x3022;
+	static const std::int32_t EGL_DEPTH_SIZE = 0x3025;
+	static const std::int32_t EGL_WIDTH = 0x3057;
+	static const std::int32_t EGL_HEIGHT = 0x3056;
+	static const unsigned int EGL_OPENGL_API = 0x30A2;
+	static const unsigned int EGL_PLATFORM_SURFACELESS_MESA = 0x31DD;
+
+	// EGL entry points; handles are opaque pointers and EGLint is 32 bits
+	typedef void* (*GetProcAddress)(const char* name);
+	typedef void* (*GetDisplay)(void* nativeDisplay);
+	typedef void* (*GetPlatformDisplay)(unsigned int platform, void* nativeDisplay, const std::int32_t* attributes);
+	typedef unsigned int (*Initialize)(void* display, std::int32_t* major, std::int32_t* minor);
+	typedef unsigned int (*Terminate)(void* display);
+	typedef unsigned int (*BindApi)(unsigned int api);
+	typedef unsigned int (*ChooseConfig)(void* display, const std::int32_t* attributes, void** configs, std::int32_t size, std::int32_t* count);
+	typedef void* (*CreateContext)(void* display, void* config, void* share, const std::int32_t* attributes);
+	typedef unsigned int (*DestroyContext)(void* display, void* context);
+	typedef void* (*CreatePbufferSurface)(void* display, void* config, const std::int32_t* attributes);
+	typedef unsigned int (*DestroySurface)(void* display, void* surface);
+	typedef unsigned int (*MakeCurrent)(void* display, void* draw, void* read, void* context);
+
+	// Framebuffer object entry points
+	typedef void (APIENTRY* GenObjects)(GLsizei count, GLuint* names);
+	typedef void (APIENTRY* BindObject)(GLenum target, GLuint name);
+	typedef void (APIENTRY* RenderbufferStorage)(GLenum target, GLenum format, GLsizei width, GLsizei height);
+	typedef void (APIENTRY* FramebufferRenderbuffer)(GLenum target, GLenum attachment, GLenum renderbufferTarget, GLuint renderbuffer);
+	typedef GLenum (APIENTRY* CheckFramebufferStatus)(GLenum target);
+
+#ifndef _WIN32
+	// Open libEGL and look up the entry points used
+	bool loadEgl()
+	{
+		if (getProcAddress) return true;
+		void* library = dlopen("libEGL.so.1", RTLD_NOW | RTLD_GLOBAL);
+		if (!library)
+		{
+			error = "libEGL.so.1 not found";
+			return false;
+		}
+
+		getProcAddress = (GetProcAddress)dlsym(library, "eglGetProcAddress");
+		getDisplay = (GetDisplay)dlsym(library, "eglGetDisplay");
+		initialize = (Initialize)dlsym(library, "eglInitialize");
+		terminate = (Terminate)dlsym(library, "eglTerminate");
+		bindApi = (BindApi)dlsym(library, "eglBindAPI");
+		chooseConfig = (ChooseConfig)dlsym(library, "eglChooseConfig");
+		createContext = (CreateContext)dlsym(library, "eglCreateContext");
+		destroyContext = (DestroyContext)dlsym(library, "eglDestroyContext");
+		createPbufferSurface = (CreatePbufferSurface)dlsym(library, "eglCreatePbufferSurface");
+		destroySurface = (DestroySurface)dlsym(library, "eglDestroySurface");
+		makeCurrent = (MakeCurrent)dlsym(library, "eglMakeCurrent");
+		if (!getProcAddress || !getDisplay || !initialize || !terminate || !bindApi || !chooseConfig || !createContext
+			|| !destroyContext || !createPbufferSurface || !destroySurface || !makeCurrent)
+		{
+			error = "libEGL.so.1 lacks EGL 1.4";
+			getProcAddress = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	// Create and bind a framebuffer with color and depth renderbuffers of the image size
+	bool createFramebuffer()
+	{
+		GenObjects genFramebuffers = (GenObjects)getProcAddress("glGenFramebuffers");
+		GenObjects genRenderbuffers = (GenObjects)getProcAddress("glGenRenderbuffers");
+		BindObject bindFramebuffer = (BindObject)getProcAddress("glBindFramebuffer");
+		BindObject bindRenderbuffer = (BindObject)getProcAddress("glBindRenderbuffer");
+		RenderbufferStorage renderbufferStorage = (RenderbufferStorage)getProcAddress("glRenderbufferStorage");
+		FramebufferRenderbuffer framebufferRenderbuffer = (FramebufferRenderbuffer)getProcAddress("glFramebufferRenderbuffer");
+		CheckFramebufferStatus checkFramebufferStatus = (CheckFramebufferStatus)getProcAddress("glCheckFramebufferStatus");
+		deleteFramebuffers = (GenObjects)getProcAddress("glDeleteFramebuffers");
+		deleteRenderbuffers = (GenObjects)getProcAddress("glDeleteRenderbuffers");
+		if (!genFramebuffers || !genRenderbuffers || !bindFramebuffer || !bindRenderbuffer || !renderbufferStorage
+			|| !framebufferRenderbuffer || !checkFramebufferStatus || !deleteFramebuffers || !deleteRenderbuffers)
+		{
+			error = "context lacks framebuffer objects";
+			return false;
+		}
+
+		genFramebuffers(1, &framebuffer);
+		bindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		genRenderbuffers(2, renderbuffers);
+		bindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+		renderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		framebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+		bindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+		renderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+		framebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+		if (checkFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			error = "framebuffer incomplete";
+			return false;
+		}
+		glViewport(0, 0, width, height);
+		return true;
+	}
+#endif
+
+	int width = 0;								// image width in pixels
+	int height = 0;								// image height in pixels
+	std::string error{};						// why the last create() failed
+	void* display = nullptr;					// EGL display
+	void* context = nullptr;					// EGL context
+	void* surface = nullptr;					// pbuffer, if the context could not be made current without one
+	GLuint framebuffer = 0;						// framebuffer drawn into
+	GLuint renderbuffers[2] = { 0, 0 };			// color and depth renderbuffers
+	GenObjects deleteFramebuffers = nullptr;
+	GenObjects deleteRenderbuffers = nullptr;
+
+	GetProcAddress getProcAddress = nullptr;
+	GetDisplay getDisplay = nullptr;
+	Initialize initialize = nullptr;
+	Terminate terminate = nullptr;
+	BindApi bindApi = nullptr;
+	ChooseConfig chooseConfig = nullptr;
+	CreateContext createContext = nullptr;
+	DestroyContext destroyContext = nullptr;
+	CreatePbufferSurface createPbufferSurface = nullptr;
+	DestroySurface destroySurface = nullptr;
+	MakeCurrent makeCurrent = nullptr;
+};
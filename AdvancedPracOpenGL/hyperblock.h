@@ -0,0 +1,317 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "GL/glut.h"
+#include "parallel.h"
+#include "dataview.h"
+#include "classlabels.h"
+
+/* Hyperblock: an axis-aligned box in n-D attribute space
+*  Each hyperblock is described by the minimum (lower) and
+*  maximum (upper) value of every attribute over its member
+*  points, along with the class it represents.
+*/
+struct Hyperblock {
+	std::vector<GLfloat> lower{};	// minimum value of each attribute
+	std::vector<GLfloat> upper{};	// maximum value of each attribute
+	ClassLabel classLabel = 0;		// class of the block
+	unsigned int size = 0;			// number of member points
+	std::string label = "";			// display / report name
+
+	/*
+	* fromPoints
+	* Construct the tightest box containing every point in the set.
+	*
+	* @param	points		member points of the block
+	*			classLabel	class of the block
+	*			label		name of the block
+	* @return	Hyperblock	box bounding the points
+	*/
+	static Hyperblock fromPoints(const std::vector<std::vector<GLfloat>>& points, ClassLabel classLabel, const std::string& label)
+	{
+		return fromPoints(DataView(points), classLabel, label);
+	}
+
+	/*
+	* fromPoints
+	* Construct the tightest box containing every row of a view.
+	*
+	* @param	points		view of the member points of the block
+	*			classLabel	class of the block
+	*			label		name of the block
+	* @return	Hyperblock	box bounding the points
+	*/
+	static Hyperblock fromPoints(const DataView& points, ClassLabel classLabel, const std::string& label)
+	{
+		Hyperblock block;
+		block.classLabel = classLabel;
+		block.label = label;
+		block.size = (unsigned int)points.size();
+
+		if (points.size() == 0) return block;
+
+		block.lower.assign(points[0].begin(), points[0].end());
+		block.upper = block.lower;
+		for (std::size_t p = 0; p < points.size(); ++p)
+		{
+			RowView point = points[p];
+			for (std::size_t i = 0; i < block.lower.size() && i < point.size(); ++i)
+			{
+				block.lower[i] = std::min(block.lower[i], point[i]);
+				block.upper[i] = std::max(block.upper[i], point[i]);
+			}
+		}
+		return block;
+	}
+
+	// Check if a point lies within the box (inclusive bounds)
+	bool contains(const std::vector<GLfloat>& point) const
+	{
+		for (std::size_t i = 0; i < lower.size() && i < point.size(); ++i)
+		{
+			if (point[i] < lower[i] || point[i] > upper[i]) return false;
+		}
+		return true;
+	}
+};
+
+/*
+* importHyperblockCatalog
+* Load every hyperblock HB1.csv ... HBn.csv from the given
+* directory. Each file lists the member points of a single
+* block, one comma-separated point per line. Loading stops at
+* the first missing file. A file with no points, a value that is
+* not a number or a point without exactly one value per attribute
+* is reported and skipped.
+*
+* @param	directory	folder containing the HB*.csv files
+*			dimension	number of attributes of every point
+* @return	vector of hyperblocks, unclassified
+*/
+inline std::vector<Hyperblock> importHyperblockCatalog(const std::string& directory, std::size_t dimension)
+{
+	std::vector<Hyperblock> catalog{};
+
+	for (unsigned int fileNum = 1; ; ++fileNum)
+	{
+		std::string name = "HB" + std::to_string(fileNum);
+		std::ifstream myFile(directory + "/" + name + ".csv");
+		if (!myFile) break;		// no more blocks in catalog
+
+		std::vector<std::vector<GLfloat>> points{};
+		std::string line = "";
+		std::string error = "";
+		for (unsigned int lineNum = 1; error.empty() && getline(myFile, line); ++lineNum)
+		{
+			if (line.empty()) continue;
+
+			// Split string into a vector
+			std::vector<GLfloat> point{};
+			std::stringstream ss(line);
+			while (ss.good() && error.empty()) {
+				std::string substr = "";
+				getline(ss, substr, ',');	// extract attribute from line
+				if (substr.empty()) continue;
+
+				std::istringstream field(substr);
+				GLfloat value = 0.0;
+				if (!(field >> value) || !(field >> std::ws).eof()) error = "line " + std::to_string(lineNum) + " has a value that is not a number";
+				point.push_back(value);
+			}
+			if (error.empty() && point.size() != dimension)
+			{
+				error = "line " + std::to_string(lineNum) + " has " + std::to_string(point.size())
+					+ " values instead of " + std::to_string(dimension);
+			}
+			points.push_back(point);
+		}
+		myFile.close();		// close file stream
+
+		if (error.empty() && points.empty()) error = "it has no points";
+		if (!error.empty())
+		{
+			std::cout << "Error: Skipping hyperblock " << name << ", " << error << ".\n";
+			continue;
+		}
+
+		catalog.push_back(Hyperblock::fromPoints(points, true, name));
+	}
+
+	return catalog;
+}
+
+/*
+* classifyHyperblocks
+* Assign each block the majority class of the weighted data
+* rows that fall inside its box.
+*
+* @param	blocks		hyperblocks to classify
+*			data		data rows
+*			counts		class counts of each data row
+*/
+inline void classifyHyperblocks(std::vector<Hyperblock>* blocks, const std::vector<std::vector<GLfloat>>& data,
+	const RowCounts& counts)
+{
+	parallelFor(blocks->size(), [&](std::size_t begin, std::size_t end, unsigned int)
+	{
+		for (std::size_t b = begin; b < end; ++b)
+		{
+			Hyperblock& block = (*blocks)[b];
+			ClassHistogram classCounts(counts.getNumClasses());
+			for (std::size_t i = 0; i < data.size(); ++i)
+			{
+				if (block.contains(data[i])) counts.addTo(i, &classCounts);
+			}
+			block.classLabel = classCounts.dominant();
+		}
+	});
+}
+
+/*
+* classifyHyperblocks
+* Assign each block the majority class of the data points
+* that fall inside its box. The catalog files do not record
+* a class, so it is recovered from the labelled data set.
+*
+* @param	blocks		hyperblocks to classify
+*			data		labelled data points
+*			classify	class of each data point
+*/
+inline void classifyHyperblocks(std::vector<Hyperblock>* blocks, const std::vector<std::vector<GLfloat>>& data,
+	const LabelColumn& classify)
+{
+	classifyHyperblocks(blocks, data, RowCounts(classify));
+}
+
+/* HyperblockOverlap: pairwise intersection of hyperblocks
+*  Finds every pair of intersecting boxes using a sort-and-sweep
+*  on the first attribute. Candidate pairs that overlap on the
+*  sweep attribute are checked on the remaining attributes with
+*  a branch-free interval test over packed bounds, and the sweep
+*  is split across worker threads.
+*/
+class HyperblockOverlap {
+public:
+	// A pair of intersecting hyperblocks
+	struct OverlapPair {
+		unsigned int first;		// index of first block
+		unsigned int second;	// index of second block
+		GLfloat volume;			// volume of the intersection box
+		bool mixedClass;		// blocks belong to different classes
+	};
+
+	/*
+	* compute
+	* Find every intersecting pair of hyperblocks. Blocks are compared
+	* over the attributes of the first non-empty block; empty blocks and
+	* blocks of another dimension are left out and counted as skipped.
+	*
+	* @param	blocks	hyperblocks to compare
+	* @return	intersecting pairs, ordered by (first, second)
+	*/
+	std::vector<OverlapPair> compute(const std::vector<Hyperblock>& blocks)
+	{
+		std::vector<OverlapPair> pairs{};
+		dimension = 0;
+		for (const Hyperblock& block : blocks)
+		{
+			if (!block.lower.empty())
+			{
+				dimension = block.lower.size();
+				break;
+			}
+		}
+		pack(blocks);
+		if (order.empty()) return pairs;
+
+		// Each worker sweeps its share of the sorted blocks into its own list
+		std::vector<std::vector<OverlapPair>> workerPairs(parallelWorkerCount());
+		parallelFor(order.size(), [&](std::size_t begin, std::size_t end, unsigned int worker)
+		{
+			std::vector<OverlapPair>& found = workerPairs[worker];
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				sweep(i, blocks, &found);
+			}
+		});
+
+		for (auto& found : workerPairs)
+		{
+			pairs.insert(pairs.end(), found.begin(), found.end());
+		}
+
+		std::sort(pairs.begin(), pairs.end(),
+			[](const OverlapPair& lhs, const OverlapPair& rhs)
+			{ return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second); });
+
+		return pairs;
+	}
+
+	// Number of blocks left out of the last comparison for being empty or of another dimension
+	std::size_t getSkipped() const { return skipped; }
+
+private:
+
+	// Sort the blocks of the compared dimension by lower bound of the sweep attribute and pack bounds contiguously
+	void pack(const std::vector<Hyperblock>& blocks)
+	{
+		order.clear();
+		for (unsigned int i = 0; i < blocks.size(); ++i)
+		{
+			if (dimension > 0 && blocks[i].lower.size() == dimension && blocks[i].upper.size() == dimension) order.push_back(i);
+		}
+		skipped = blocks.size() - order.size();
+		std::sort(order.begin(), order.end(),
+			[&](unsigned int lhs, unsigned int rhs) { return blocks[lhs].lower[0] < blocks[rhs].lower[0]; });
+
+		lowerBounds.resize(order.size() * dimension);
+		upperBounds.resize(order.size() * dimension);
+		for (std::size_t i = 0; i < order.size(); ++i)
+		{
+			const Hyperblock& block = blocks[order[i]];
+			std::copy(block.lower.begin(), block.lower.end(), lowerBounds.begin() + i * dimension);
+			std::copy(block.upper.begin(), block.upper.end(), upperBounds.begin() + i * dimension);
+		}
+	}
+
+	// Compare sorted block i to every later block that starts before it ends
+	void sweep(std::size_t i, const std::vector<Hyperblock>& blocks, std::vector<OverlapPair>* found)
+	{
+		const GLfloat* lowA = &lowerBounds[i * dimension];
+		const GLfloat* upA = &upperBounds[i * dimension];
+
+		for (std::size_t j = i + 1; j < order.size(); ++j)
+		{
+			const GLfloat* lowB = &lowerBounds[j * dimension];
+			const GLfloat* upB = &upperBounds[j * dimension];
+
+			// Sorted by lower bound: no later block can overlap on the sweep attribute
+			if (lowB[0] > upA[0]) break;
+
+			// Branch-free interval test over every attribute
+			GLfloat volume = 1.0;
+			GLfloat minExtent = 0.0;
+			for (std::size_t d = 0; d < dimension; ++d)
+			{
+				GLfloat extent = std::min(upA[d], upB[d]) - std::max(lowA[d], lowB[d]);
+				minExtent = std::min(minExtent, extent);
+				volume *= std::max(extent, 0.0f);
+			}
+			if (minExtent < 0.0) continue;	// disjoint on some attribute
+
+			unsigned int a = std::min(order[i], order[j]);
+			unsigned int b = std::max(order[i], order[j]);
+			found->push_back({ a, b, volume, blocks[a].classLabel != blocks[b].classLabel });
+		}
+	}
+
+	std::size_t dimension = 0;				// attributes per block
+	std::size_t skipped = 0;				// blocks left out of the last comparison
+	std::vector<unsigned int> order{};		// block indices sorted by sweep attribute
+	std::vector<GLfloat> lowerBounds{};		// packed lower bounds in sweep order
+	std::vector<GLfloat> upperBounds{};		// packed upper bounds in sweep order
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+#include "GL/glut.h"
+#include "hyperblock.h"
+#include "glyphgeometry.h"
+#include "glyphmapping.h"
+#include "parallelcoords.h"
+#include "vertexbatch.h"
+
+/* Hyperblock envelopes: the extent of each block, drawn from its bounds
+*  Instead of drawing every member point, a block is drawn as one
+*  translucent band per pair of adjacent axes in parallel
+*  coordinates, running from its minimum to its maximum on each axis,
+*  and as one translucent box per paired coordinate plot in SPC
+*  space, spanning the bounds of the attributes placed on that plot.
+*  The cost is a few triangles per block whatever its size. Bounds
+*  are in the same [0, 1] units as the drawn rows.
+*/
+
+/*
+* batchQuad
+* Add a quad as two triangles, corners in order around it.
+*
+* @param	batch		triangle batch in window coordinates
+*			x, y		the four corners
+*/
+inline void batchQuad(VertexBatch* batch, const GLfloat x[4], const GLfloat y[4])
+{
+	const unsigned int corners[6] = { 0, 1, 2, 0, 2, 3 };
+	for (unsigned int corner : corners) batch->addVertex(x[corner], y[corner]);
+}
+
+/*
+* batchHyperblockBands
+* Add the band of every block between each pair of adjacent axes of
+* a parallel coordinates view.
+*
+* @param	blocks			hyperblocks to draw
+*			view			parallel coordinates giving the axis order and placement
+*			width, height	window size in pixels
+*			palette			red, green and blue of each class
+*			alpha			opacity of the bands
+*			bands			triangle batch to add the bands to
+*/
+inline void batchHyperblockBands(const std::vector<Hyperblock>& blocks, const ParallelCoordinates& view, int width, int height,
+	const std::vector<GLfloat>& palette, GLfloat alpha, VertexBatch* bands)
+{
+	const std::vector<unsigned int>& order = view.getOrder();
+	bands->setWindow();
+	for (const Hyperblock& block : blocks)
+	{
+		const GLfloat* color = &palette[3 * block.classLabel];
+		bands->setColor(color[0], color[1], color[2], alpha);
+		for (std::size_t position = 0; position + 1 < order.size(); ++position)
+		{
+			unsigned int left = order[position];
+			unsigned int right = order[position + 1];
+			if (left >= block.lower.size() || right >= block.lower.size()) continue;
+
+			GLfloat x[4] = { view.axisX(position, width), view.axisX(position, width),
+				view.axisX(position + 1, width), view.axisX(position + 1, width) };
+			GLfloat y[4] = { height * block.lower[left], height * block.upper[left],
+				height * block.upper[right], height * block.lower[right] };
+			batchQuad(bands, x, y);
+		}
+	}
+}
+
+/*
+* batchHyperblockBoxes
+* Add the box of every block in each of the three paired coordinate
+* plots of the SPC view.
+*
+* @param	blocks		hyperblocks to draw
+*			mapping		columns placed on the axes of each plot
+*			layout		placement of the plots in the window
+*			palette		red, green and blue of each class
+*			alpha		opacity of the boxes
+*			boxes		triangle batch to add the boxes to
+*/
+inline void batchHyperblockBoxes(const std::vector<Hyperblock>& blocks, const GlyphMapping& mapping, const GlyphLayout& layout,
+	const std::vector<GLfloat>& palette, GLfloat alpha, VertexBatch* boxes)
+{
+	GLfloat offset = layout.edgeOffset();
+	boxes->setWindow();
+	for (const Hyperblock& block : blocks)
+	{
+		if (block.lower.empty()) continue;
+
+		// Corners of the box in every plot, placed as a located glyph would be
+		GLfloat lower[6], upper[6], lowerCorner[6], upperCorner[6];
+		mapping.positions(RowView(block.lower), lower);
+		mapping.positions(RowView(block.upper), upper);
+		layout.anchors(lower, lowerCorner);
+		layout.anchors(upper, upperCorner);
+
+		const GLfloat* color = &palette[3 * block.classLabel];
+		boxes->setColor(color[0], color[1], color[2], alpha);
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			GLfloat left = lowerCorner[2 * k] + offset;
+			GLfloat bottom = lowerCorner[2 * k + 1] + offset;
+			GLfloat right = upperCorner[2 * k] + offset;
+			GLfloat top = upperCorner[2 * k + 1] + offset;
+			GLfloat x[4] = { left, left, right, right };
+			GLfloat y[4] = { bottom, top, top, bottom };
+			batchQuad(boxes, x, y);
+		}
+	}
+}
@@ -0,0 +1,493 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include "GL/glut.h"
+#include "hyperblock.h"
+
+/* BoxIndex: uniform grid index over hyperblock boxes
+*  The first (up to) two attributes are divided into square cells of
+*  fixed width, and each block is registered in every cell its box
+*  covers. Point and range queries return the blocks registered in
+*  the covered cells, which are then checked exactly by the caller.
+*/
+class BoxIndex {
+public:
+	// Constructor
+	BoxIndex(GLfloat cellWidth = 1.0) : cellWidth(cellWidth) {}
+
+	// Register a block in every cell its box covers
+	void insert(unsigned int blockId, const Hyperblock& block)
+	{
+		forEachCell(block.lower, block.upper, [&](long long key) { cells[key].push_back(blockId); });
+	}
+
+	// Remove a block from every cell its box covers
+	void remove(unsigned int blockId, const Hyperblock& block)
+	{
+		forEachCell(block.lower, block.upper, [&](long long key)
+		{
+			std::vector<unsigned int>& cell = cells[key];
+			cell.erase(std::remove(cell.begin(), cell.end(), blockId), cell.end());
+		});
+	}
+
+	/*
+	* query
+	* Collect the ids of blocks registered in any cell overlapping
+	* the box [lower, upper]. Each id is reported once.
+	*
+	* @param	lower	minimum corner of query box
+	*			upper	maximum corner of query box
+	*			found	output vector of candidate block ids
+	*/
+	void query(const std::vector<GLfloat>& lower, const std::vector<GLfloat>& upper, std::vector<unsigned int>* found)
+	{
+		found->clear();
+		++stamp;
+		forEachCell(lower, upper, [&](long long key)
+		{
+			auto cell = cells.find(key);
+			if (cell == cells.end()) return;
+			for (unsigned int blockId : cell->second)
+			{
+				if (blockId >= seen.size()) seen.resize(blockId + 1, 0);
+				if (seen[blockId] == stamp) continue;
+				seen[blockId] = stamp;
+				found->push_back(blockId);
+			}
+		});
+	}
+
+private:
+
+	// Visit the key of every cell covered by the box on the indexed attributes
+	template <typename Visit>
+	void forEachCell(const std::vector<GLfloat>& lower, const std::vector<GLfloat>& upper, Visit visit)
+	{
+		long long lowX = cellOf(lower[0]);
+		long long highX = cellOf(upper[0]);
+		long long lowY = (lower.size() > 1) ? cellOf(lower[1]) : 0;
+		long long highY = (upper.size() > 1) ? cellOf(upper[1]) : 0;
+
+		for (long long x = lowX; x <= highX; ++x)
+		{
+			for (long long y = lowY; y <= highY; ++y)
+			{
+				visit((x << 32) ^ (y & 0xFFFFFFFF));
+			}
+		}
+	}
+
+	long long cellOf(GLfloat value) { return (long long)std::floor(value / cellWidth); }
+
+	GLfloat cellWidth;											// width of a grid cell
+	std::unordered_map<long long, std::vector<unsigned int>> cells{};	// block ids per cell
+	std::vector<unsigned int> seen{};							// last query stamp per block id
+	unsigned int stamp = 0;										// current query stamp
+};
+
+/* HyperblockModel: incrementally maintained set of pure hyperblocks
+*  Labelled rows are inserted one at a time. A new row is located
+*  with the box index and then:
+*    - joins a containing block of its own class,
+*    - splits any containing block of another class, so that the
+*      block stays pure, and
+*    - expands the nearest block of its own class within the
+*      tolerance if the grown box stays pure, or opens a new block.
+*  The cost of an insertion depends on the neighborhood of the row,
+*  not on the size of the model. The model is saved as its rows and
+*  the member rows of each block, so a later run reloads the blocks
+*  as they were, without inserting any row again.
+*/
+class HyperblockModel {
+public:
+	// Constructor
+	HyperblockModel(GLfloat tolerance = 3.0) : tolerance(tolerance), index(tolerance) {}
+
+	// Insert every row of a labelled set, in order
+	void insertRows(const std::vector<std::vector<GLfloat>>& data, const LabelColumn& classify)
+	{
+		for (std::size_t i = 0; i < data.size() && i < classify.size(); ++i)
+		{
+			insert(data[i], classify[i]);
+		}
+	}
+
+	/*
+	* insert
+	* Add a single labelled row to the model.
+	*
+	* @param	row			attributes of the new row
+	*			classLabel	class of the new row
+	*/
+	void insert(const std::vector<GLfloat>& row, ClassLabel classLabel)
+	{
+		unsigned int rowId = (unsigned int)rows.size();
+		rows.push_back(row);
+		rowClass.push_back(classLabel);
+
+		// Locate blocks containing the new row
+		index.query(row, row, &candidates);
+		std::vector<unsigned int> containing{};
+		for (unsigned int blockId : candidates)
+		{
+			if (blocks[blockId].contains(row)) containing.push_back(blockId);
+		}
+
+		// Split blocks of the other class, join a block of the same class
+		// (blocks appended by a split never contain the row)
+		int sameClassBlock = -1;
+		for (unsigned int blockId : containing)
+		{
+			if (blocks[blockId].classLabel == classLabel)
+			{
+				if (sameClassBlock < 0) sameClassBlock = (int)blockId;
+			}
+			else
+			{
+				split(blockId, row);
+			}
+		}
+
+		if (sameClassBlock >= 0 && blocks[sameClassBlock].contains(row))
+		{
+			addMember((unsigned int)sameClassBlock, rowId);
+			return;
+		}
+
+		// Grow the nearest pure block of the same class, or open a new block
+		int nearest = nearestExpandable(row, classLabel);
+		if (nearest >= 0)
+		{
+			index.remove((unsigned int)nearest, blocks[nearest]);
+			addMember((unsigned int)nearest, rowId);
+			index.insert((unsigned int)nearest, blocks[nearest]);
+			return;
+		}
+
+		Hyperblock block;
+		block.lower = row;
+		block.upper = row;
+		block.classLabel = classLabel;
+		block.label = "HB" + std::to_string(blocks.size() + 1);
+		blocks.push_back(block);
+		members.push_back(std::vector<unsigned int>{});
+		addMember((unsigned int)(blocks.size() - 1), rowId);
+		index.insert((unsigned int)(blocks.size() - 1), blocks.back());
+	}
+
+	// Get the current hyperblocks
+	const std::vector<Hyperblock>& getBlocks() { return blocks; }
+
+	// Get the row ids belonging to a block
+	const std::vector<unsigned int>& getMembers(unsigned int blockId) { return members[blockId]; }
+
+	// Get the number of rows in the model
+	std::size_t getRowCount() { return rows.size(); }
+
+	// Get the number of attributes of each row, 0 while the model is empty
+	std::size_t getWidth() { return rows.empty() ? 0 : rows[0].size(); }
+
+	/*
+	* save
+	* Write the model to a file: one "row" line per row (class, then
+	* attributes) and one "block" line per block (class, label, then
+	* member row ids).
+	*
+	* @param	fileName	file to write
+	* @return				true if the file was written
+	*/
+	bool save(const std::string& fileName)
+	{
+		std::ofstream myFile(fileName);
+		for (std::size_t r = 0; r < rows.size(); ++r)
+		{
+			myFile << "row," << rowClass[r];
+			for (GLfloat value : rows[r]) myFile << "," << value;
+			myFile << "\n";
+		}
+		for (std::size_t b = 0; b < blocks.size(); ++b)
+		{
+			myFile << "block," << blocks[b].classLabel << "," << blocks[b].label;
+			for (unsigned int rowId : members[b]) myFile << "," << rowId;
+			myFile << "\n";
+		}
+		return (bool)myFile;
+	}
+
+	/*
+	* load
+	* Replace the model with one written by save. Block bounds are
+	* refitted from their members and the box index is rebuilt.
+	*
+	* @param	fileName	file to read
+	* @return				true if the file was read; the model is left empty otherwise
+	*/
+	bool load(const std::string& fileName)
+	{
+		*this = HyperblockModel(tolerance);
+		std::ifstream myFile(fileName);
+		if (!myFile) return false;
+
+		std::string line = "";
+		while (getline(myFile, line))
+		{
+			if (line.empty()) continue;
+			std::stringstream ss(line);
+			std::string kind = "";
+			std::string field = "";
+			getline(ss, kind, ',');
+			getline(ss, field, ',');
+			int classLabel = 0;
+			if (!parseNumber(field, &classLabel) || classLabel < 0) return fail();
+
+			if (kind == "row")
+			{
+				std::vector<GLfloat> row{};
+				GLfloat value = 0.0;
+				while (getline(ss, field, ','))
+				{
+					if (!parseNumber(field, &value)) return fail();
+					row.push_back(value);
+				}
+				if (row.empty() || (!rows.empty() && row.size() != rows[0].size())) return fail();
+				rows.push_back(row);
+				rowClass.push_back((ClassLabel)classLabel);
+			}
+			else if (kind == "block")
+			{
+				Hyperblock block;
+				block.classLabel = (ClassLabel)classLabel;
+				getline(ss, block.label, ',');
+				std::vector<unsigned int> blockMembers{};
+				int rowId = 0;
+				while (getline(ss, field, ','))
+				{
+					if (!parseNumber(field, &rowId) || rowId < 0 || (std::size_t)rowId >= rows.size()) return fail();
+					blockMembers.push_back((unsigned int)rowId);
+				}
+				if (blockMembers.empty()) return fail();
+				blocks.push_back(block);
+				members.push_back(blockMembers);
+				refit((unsigned int)(blocks.size() - 1));
+				index.insert((unsigned int)(blocks.size() - 1), blocks.back());
+			}
+			else return fail();
+		}
+		return true;
+	}
+
+private:
+
+	// Read a whole field as a number, rejecting anything left over
+	template <typename Number>
+	static bool parseNumber(const std::string& field, Number* value)
+	{
+		std::istringstream sin(field);
+		sin >> *value;
+		return !sin.fail() && (sin >> std::ws).eof();
+	}
+
+	// Empty the model after a failed load
+	bool fail()
+	{
+		*this = HyperblockModel(tolerance);
+		return false;
+	}
+
+	// Add a row to a block, growing its bounds
+	void addMember(unsigned int blockId, unsigned int rowId)
+	{
+		Hyperblock& block = blocks[blockId];
+		const std::vector<GLfloat>& row = rows[rowId];
+		for (std::size_t i = 0; i < block.lower.size(); ++i)
+		{
+			block.lower[i] = std::min(block.lower[i], row[i]);
+			block.upper[i] = std::max(block.upper[i], row[i]);
+		}
+		members[blockId].push_back(rowId);
+		block.size = (unsigned int)members[blockId].size();
+	}
+
+	// Recompute the tight bounds of a block from its members
+	void refit(unsigned int blockId)
+	{
+		Hyperblock& block = blocks[blockId];
+		block.lower = rows[members[blockId].front()];
+		block.upper = block.lower;
+		for (unsigned int rowId : members[blockId])
+		{
+			for (std::size_t i = 0; i < block.lower.size(); ++i)
+			{
+				block.lower[i] = std::min(block.lower[i], rows[rowId][i]);
+				block.upper[i] = std::max(block.upper[i], rows[rowId][i]);
+			}
+		}
+		block.size = (unsigned int)members[blockId].size();
+	}
+
+	/*
+	* split
+	* Split a block around a row of the other class, so that none of
+	* the refitted parts contains the row. Members are partitioned on
+	* the attribute with the fewest ties to the row (then the most
+	* balanced halves); members tied with the row on that attribute
+	* are partitioned again on the remaining attributes. Exact
+	* duplicates of the row are kept together in their own part.
+	*/
+	void split(unsigned int blockId, const std::vector<GLfloat>& row)
+	{
+		std::vector<std::vector<unsigned int>> parts{};
+		std::vector<bool> usedAttr(row.size(), false);
+		partition(members[blockId], row, &usedAttr, &parts);
+		if (parts.size() < 2) return;	// only duplicates of the row
+
+		index.remove(blockId, blocks[blockId]);
+		members[blockId] = parts.front();
+		refit(blockId);
+		index.insert(blockId, blocks[blockId]);
+
+		for (std::size_t part = 1; part < parts.size(); ++part)
+		{
+			Hyperblock partBlock = blocks[blockId];
+			partBlock.label = "HB" + std::to_string(blocks.size() + 1);
+			blocks.push_back(partBlock);
+			members.push_back(parts[part]);
+			refit((unsigned int)(blocks.size() - 1));
+			index.insert((unsigned int)(blocks.size() - 1), blocks.back());
+		}
+	}
+
+	// Recursively partition members into groups whose boxes exclude the row
+	void partition(const std::vector<unsigned int>& group, const std::vector<GLfloat>& row,
+		std::vector<bool>* usedAttr, std::vector<std::vector<unsigned int>>* parts)
+	{
+		int bestAttr = -1;
+		std::size_t bestTies = 0;
+		std::size_t bestBalance = 0;
+
+		for (std::size_t attr = 0; attr < row.size(); ++attr)
+		{
+			if ((*usedAttr)[attr]) continue;
+
+			std::size_t below = 0;
+			std::size_t above = 0;
+			for (unsigned int rowId : group)
+			{
+				if (rows[rowId][attr] < row[attr]) ++below;
+				else if (rows[rowId][attr] > row[attr]) ++above;
+			}
+			std::size_t ties = group.size() - below - above;
+			if (ties == group.size()) continue;	// attribute cannot separate the group
+
+			std::size_t balance = std::min(below, above);
+			if (bestAttr < 0 || ties < bestTies || (ties == bestTies && balance > bestBalance))
+			{
+				bestAttr = (int)attr;
+				bestTies = ties;
+				bestBalance = balance;
+			}
+		}
+
+		if (bestAttr < 0)
+		{	// every member duplicates the row on the remaining attributes
+			parts->push_back(group);
+			return;
+		}
+
+		std::vector<unsigned int> lowerPart{};
+		std::vector<unsigned int> upperPart{};
+		std::vector<unsigned int> tiedPart{};
+		for (unsigned int rowId : group)
+		{
+			if (rows[rowId][bestAttr] < row[bestAttr])		lowerPart.push_back(rowId);
+			else if (rows[rowId][bestAttr] > row[bestAttr])	upperPart.push_back(rowId);
+			else											tiedPart.push_back(rowId);
+		}
+
+		if (!lowerPart.empty()) parts->push_back(lowerPart);
+		if (!upperPart.empty()) parts->push_back(upperPart);
+		if (!tiedPart.empty())
+		{
+			(*usedAttr)[bestAttr] = true;
+			partition(tiedPart, row, usedAttr, parts);
+			(*usedAttr)[bestAttr] = false;
+		}
+	}
+
+	// Find the same-class block within tolerance whose grown box stays pure and grows least
+	int nearestExpandable(const std::vector<GLfloat>& row, ClassLabel classLabel)
+	{
+		std::vector<GLfloat> lower(row);
+		std::vector<GLfloat> upper(row);
+		for (std::size_t i = 0; i < row.size(); ++i)
+		{
+			lower[i] -= tolerance;
+			upper[i] += tolerance;
+		}
+		index.query(lower, upper, &candidates);
+		std::vector<unsigned int> nearby(candidates);
+
+		int best = -1;
+		GLfloat bestGrowth = 0.0;
+		for (unsigned int blockId : nearby)
+		{
+			const Hyperblock& block = blocks[blockId];
+			if (block.classLabel != classLabel) continue;
+
+			// Every attribute must be within tolerance of the box
+			GLfloat growth = 0.0;
+			bool withinTolerance = true;
+			for (std::size_t i = 0; i < row.size(); ++i)
+			{
+				GLfloat outside = std::max(block.lower[i] - row[i], row[i] - block.upper[i]);
+				outside = std::max(outside, 0.0f);
+				withinTolerance = withinTolerance && (outside <= tolerance);
+				growth += outside;
+			}
+			if (!withinTolerance) continue;
+			if (best >= 0 && growth >= bestGrowth) continue;
+			if (!staysPure(block, row, classLabel)) continue;
+
+			best = (int)blockId;
+			bestGrowth = growth;
+		}
+		return best;
+	}
+
+	// Check that growing a block to include the row does not cover rows of another class
+	bool staysPure(const Hyperblock& block, const std::vector<GLfloat>& row, ClassLabel classLabel)
+	{
+		Hyperblock grown = block;
+		for (std::size_t i = 0; i < row.size(); ++i)
+		{
+			grown.lower[i] = std::min(grown.lower[i], row[i]);
+			grown.upper[i] = std::max(grown.upper[i], row[i]);
+		}
+
+		std::vector<unsigned int> overlapping{};
+		index.query(grown.lower, grown.upper, &overlapping);
+		for (unsigned int blockId : overlapping)
+		{
+			if (blocks[blockId].classLabel == classLabel) continue;
+			for (unsigned int rowId : members[blockId])
+			{
+				if (grown.contains(rows[rowId])) return false;
+			}
+		}
+		return true;
+	}
+
+	GLfloat tolerance;									// max distance a block may grow per attribute
+	BoxIndex index;										// grid index over block boxes
+	std::vector<std::vector<GLfloat>> rows{};			// all inserted rows
+	std::vector<ClassLabel> rowClass{};					// class of each inserted row
+	std::vector<Hyperblock> blocks{};					// current hyperblocks
+	std::vector<std::vector<unsigned int>> members{};	// row ids of each block
+	std::vector<unsigned int> candidates{};				// scratch query results
+};
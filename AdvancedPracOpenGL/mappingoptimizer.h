@@ -0,0 +1,279 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "GL/glut.h"
+#include "dataview.h"
+#include "classlabels.h"
+#include "classstats.h"
+#include "glyphmapping.h"
+#include "parallel.h"
+
+/* MappingOptimizer: search for the glyph mapping that best shows the classes
+*  Each of the three SPC position pairs is scored on a sample of the
+*  data by rasterizing the pair's two attributes into a grid: the
+*  weighted purity of the cells rewards class separation, and the
+*  share of the grid left unused penalizes clutter. Pair scores are
+*  cached for every pair of attributes, and the three pairs are chosen
+*  by a branch-and-bound search that workers run in parallel from
+*  different first pairs. Stick figure angles and lengths go to the
+*  attributes whose class means are furthest apart relative to their
+*  spread within the classes.
+*/
+class MappingOptimizer {
+public:
+	/*
+	* MappingOptimizer
+	* Constructor.
+	*
+	* @param	sampleSize		maximum number of rows scored
+	*			gridSize		cells along each side of a pair's grid
+	*			clutterWeight	weight of clutter against class separation
+	*/
+	MappingOptimizer(std::size_t sampleSize = 500, unsigned int gridSize = 16, GLfloat clutterWeight = 0.25)
+		: sampleSize(sampleSize), gridSize(gridSize), clutterWeight(clutterWeight) {}
+
+	/*
+	* optimize
+	* Find the SPC position pairs and stick figure attributes that best
+	* separate the classes. Channels not searched keep their columns
+	* from the initial mapping.
+	*
+	* @param	data		view of the rows to score
+	*			counts		class counts of each row, by row id
+	*			dims		number of attributes per row
+	*			initial		mapping to start from
+	* @return	best mapping found
+	*/
+	GlyphMapping optimize(const DataView& data, const RowCounts& counts, std::size_t dims, const GlyphMapping& initial)
+	{
+		GlyphMapping mapping = initial;
+		if (data.size() == 0 || dims < 2) return mapping;
+
+		// Score an evenly spaced sample of the rows
+		std::vector<unsigned int> sampleIds{};
+		std::size_t stride = std::max<std::size_t>(1, data.size() / sampleSize);
+		for (std::size_t i = 0; i < data.size() && sampleIds.size() < sampleSize; i += stride)
+		{
+			sampleIds.push_back(data.id(i));
+		}
+		DataView sample(data.getRows(), sampleIds);
+		ColumnarData columns = ColumnarData::fromView(sample, dims);
+
+		std::vector<ClassLabel> labels(sample.size());
+		std::vector<unsigned int> weights(sample.size());
+		for (std::size_t r = 0; r < sample.size(); ++r)
+		{
+			labels[r] = counts.dominant(sample.id(r));
+			weights[r] = counts.weight(sample.id(r));
+		}
+
+		scorePairs(columns, sample, counts);
+		searchPositions(dims);
+		for (std::size_t p = 0; p < 3; ++p)
+		{
+			mapping.position[2 * p] = pairs[bestPairs[p]].first;
+			mapping.position[2 * p + 1] = pairs[bestPairs[p]].second;
+		}
+
+		// Angles take the two most separating attributes, lengths the next two
+		std::vector<unsigned int> ranked = rankAttributes(columns, labels, weights, (unsigned int)counts.getNumClasses());
+		const std::size_t stickOrder[4] = { 0, 2, 1, 3 };
+		for (std::size_t slot = 0; slot < 4; ++slot)
+		{
+			mapping.stick[stickOrder[slot]] = ranked[slot % ranked.size()];
+		}
+
+		return mapping;
+	}
+
+	// Score of the last optimized position pairs
+	GLfloat getScore() const { return bestScore; }
+
+	// Cached score of the pair of attributes (a, b), with a < b
+	GLfloat pairScore(unsigned int a, unsigned int b) const { return pairScores[a * numDims + b]; }
+
+private:
+
+	// Score every pair of attributes on the sample
+	void scorePairs(const ColumnarData& columns, const DataView& sample, const RowCounts& counts)
+	{
+		numDims = columns.numDims;
+		pairs.clear();
+		for (unsigned int a = 0; a < numDims; ++a)
+		{
+			for (unsigned int b = a + 1; b < numDims; ++b) pairs.push_back(std::make_pair(a, b));
+		}
+		pairScores.assign(numDims * numDims, 0.0);
+
+		// Grid cell of every sample value
+		std::vector<unsigned int> cells(columns.values.size());
+		for (std::size_t d = 0; d < numDims; ++d)
+		{
+			GLfloat range = columns.columnMax[d] - columns.columnMin[d];
+			const GLfloat* column = columns.column(d);
+			for (std::size_t r = 0; r < columns.numRows; ++r)
+			{
+				unsigned int cell = (range > 0.0) ? (unsigned int)((column[r] - columns.columnMin[d]) / range * gridSize) : 0;
+				cells[d * columns.numRows + r] = std::min(cell, gridSize - 1);
+			}
+		}
+
+		parallelFor(pairs.size(), [&](std::size_t begin, std::size_t end, unsigned int)
+		{
+			std::vector<ClassHistogram> grid(gridSize * gridSize, ClassHistogram(counts.getNumClasses()));
+			for (std::size_t p = begin; p < end; ++p)
+			{
+				unsigned int a = pairs[p].first;
+				unsigned int b = pairs[p].second;
+				for (auto& cell : grid) cell.clear();
+
+				for (std::size_t r = 0; r < columns.numRows; ++r)
+				{
+					unsigned int cell = cells[a * columns.numRows + r] * gridSize + cells[b * columns.numRows + r];
+					counts.addTo(sample.id(r), &grid[cell]);
+				}
+
+				unsigned int total = 0;
+				unsigned int dominant = 0;
+				unsigned int occupied = 0;
+				for (const auto& cell : grid)
+				{
+					if (cell.getTotal() == 0) continue;
+					total += cell.getTotal();
+					dominant += cell.count(cell.dominant());
+					++occupied;
+				}
+
+				GLfloat separation = (total > 0) ? (GLfloat)dominant / total : 0.0f;
+				GLfloat clutter = 1.0f - (GLfloat)occupied / std::min<std::size_t>(grid.size(), columns.numRows);
+				pairScores[a * numDims + b] = separation - clutterWeight * clutter;
+			}
+		});
+	}
+
+	// Choose the three position pairs with the highest total score
+	void searchPositions(std::size_t dims)
+	{
+		// Attributes may be reused only when there are too few for six distinct positions
+		maxUses = (unsigned int)((6 + dims - 1) / dims);
+		bestPairs.assign(3, 0);
+		bestScore = std::numeric_limits<GLfloat>::lowest();
+
+		// Workers search from different first pairs; later pairs follow in increasing order
+		std::vector<GLfloat> workerScore(parallelWorkerCount(), std::numeric_limits<GLfloat>::lowest());
+		std::vector<std::vector<std::size_t>> workerPairs(parallelWorkerCount(), std::vector<std::size_t>(3, 0));
+		parallelFor(pairs.size(), [&](std::size_t begin, std::size_t end, unsigned int worker)
+		{
+			std::vector<unsigned int> uses(numDims, 0);
+			std::vector<std::size_t> chosen(3, 0);
+			for (std::size_t first = begin; first < end; ++first)
+			{
+				chosen[0] = first;
+				++uses[pairs[first].first];
+				++uses[pairs[first].second];
+				branch(1, first + 1, pairScore(pairs[first].first, pairs[first].second),
+					&uses, &chosen, &workerScore[worker], &workerPairs[worker]);
+				--uses[pairs[first].first];
+				--uses[pairs[first].second];
+			}
+		});
+
+		for (std::size_t worker = 0; worker < workerScore.size(); ++worker)
+		{
+			if (workerScore[worker] > bestScore)
+			{
+				bestScore = workerScore[worker];
+				bestPairs = workerPairs[worker];
+			}
+		}
+	}
+
+	// Extend a partial choice of pairs, pruning branches that cannot beat the best found
+	void branch(std::size_t depth, std::size_t next, GLfloat partial, std::vector<unsigned int>* uses,
+		std::vector<std::size_t>* chosen, GLfloat* best, std::vector<std::size_t>* bestChosen) const
+	{
+		if (depth == 3)
+		{
+			if (partial > *best)
+			{
+				*best = partial;
+				*bestChosen = *chosen;
+			}
+			return;
+		}
+
+		// Bound: every remaining pair scores at most the best pair still available
+		GLfloat bound = std::numeric_limits<GLfloat>::lowest();
+		for (std::size_t p = next; p < pairs.size(); ++p)
+		{
+			if (available(pairs[p], *uses)) bound = std::max(bound, pairScore(pairs[p].first, pairs[p].second));
+		}
+		if (partial + (3 - depth) * bound <= *best) return;
+
+		for (std::size_t p = next; p < pairs.size(); ++p)
+		{
+			if (!available(pairs[p], *uses)) continue;
+
+			(*chosen)[depth] = p;
+			++(*uses)[pairs[p].first];
+			++(*uses)[pairs[p].second];
+			branch(depth + 1, p + 1, partial + pairScore(pairs[p].first, pairs[p].second), uses, chosen, best, bestChosen);
+			--(*uses)[pairs[p].first];
+			--(*uses)[pairs[p].second];
+		}
+	}
+
+	bool available(const std::pair<unsigned int, unsigned int>& pair, const std::vector<unsigned int>& uses) const
+	{
+		return uses[pair.first] < maxUses && uses[pair.second] < maxUses;
+	}
+
+	// Order the attributes by the spread of their class means relative to the spread within classes
+	static std::vector<unsigned int> rankAttributes(const ColumnarData& columns, const std::vector<ClassLabel>& labels,
+		const std::vector<unsigned int>& weights, unsigned int numClasses)
+	{
+		ClassStatistics stats;
+		stats.compute(columns, labels, weights, numClasses);
+
+		std::vector<double> separation(columns.numDims, 0.0);
+		for (std::size_t d = 0; d < columns.numDims; ++d)
+		{
+			double total = 0.0;
+			double mean = 0.0;
+			for (unsigned int c = 0; c < numClasses; ++c)
+			{
+				total += stats.count(c);
+				mean += stats.count(c) * stats.get(c, d).mean;
+			}
+			if (total == 0.0) continue;
+			mean /= total;
+
+			double between = 0.0;
+			double within = 0.0;
+			for (unsigned int c = 0; c < numClasses; ++c)
+			{
+				double delta = stats.get(c, d).mean - mean;
+				between += stats.count(c) * delta * delta;
+				within += stats.count(c) * stats.get(c, d).variance();
+			}
+			separation[d] = between / (within + 1e-9);
+		}
+
+		std::vector<unsigned int> ranked(columns.numDims);
+		for (unsigned int d = 0; d < ranked.size(); ++d) ranked[d] = d;
+		std::stable_sort(ranked.begin(), ranked.end(),
+			[&](unsigned int lhs, unsigned int rhs) { return separation[lhs] > separation[rhs]; });
+		return ranked;
+	}
+
+	std::size_t sampleSize;			// maximum number of rows scored
+	unsigned int gridSize;			// cells along each side of a pair's grid
+	GLfloat clutterWeight;			// weight of clutter against class separation
+	std::size_t numDims = 0;		// attributes per row
+	unsigned int maxUses = 1;		// times an attribute may appear among the positions
+	std::vector<std::pair<unsigned int, unsigned int>> pairs{};	// every pair of attributes (a < b)
+	std::vector<GLfloat> pairScores{};		// cached score of each pair, by a * numDims + b
+	std::vector<std::size_t> bestPairs{};	// indices in pairs of the best position pairs
+	GLfloat bestScore = 0.0;				// total score of the best position pairs
+};
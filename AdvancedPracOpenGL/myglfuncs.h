@@ -2,6 +2,7 @@
 #include "gl/glut.h"
 #include "point2.h"
 #include "vec2.h"
+#include "vertexbatch.h"
 
 
 //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> drawTileFrame >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -54,6 +55,32 @@ void drawArrow(Point2 start, Point2 end, const unsigned int winHeight)
     glEnd();
 };
 
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> batchArrow >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+// Append the arrow drawArrow would draw to a line batch and a triangle batch
+void batchArrow(VertexBatch* lines, VertexBatch* tips, Point2 start, Point2 end, const unsigned int winHeight)
+{
+    // Line Segment
+    lines->addLine((GLint)start.getx(), (GLint)start.gety(), (GLint)end.getx(), (GLint)end.gety());
+
+    // Trangle for arrow tip
+    Vec2 p1 = { float(start.getx()), float(start.gety()) };
+    Vec2 p2 = { float(end.getx()), float(end.gety()) };
+
+    Vec2 direction = p2 - p1;
+    direction.Normalize();
+
+    Vec2 perpendicular = Vec2(direction);
+    perpendicular.Perpendicu();
+
+    Vec2 pt1 = p2 - direction * (winHeight / 80) * 3;
+    Vec2 pt2 = pt1 - perpendicular * (winHeight / 80);
+    Vec2 pt3 = pt1 + perpendicular * (winHeight / 80);
+
+    tips->addVertex((GLint)p2.getx(), (GLint)p2.gety());
+    tips->addVertex((GLint)pt2.getx(), (GLint)pt2.gety());
+    tips->addVertex((GLint)pt3.getx(), (GLint)pt3.gety());
+};
+
 //>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> drawDot >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 void drawDot(GLint x, GLint y)
 {
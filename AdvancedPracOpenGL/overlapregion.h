@@ -0,0 +1,191 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include "GL/glut.h"
+#include "dataview.h"
+#include "classlabels.h"
+#include "parallel.h"
+#include "thresholdpredicate.h"
+
+/* OverlapRegions: cross-class neighbors within a per-attribute tolerance
+*  Two points overlap when every attribute differs by no more than
+*  that attribute's tolerance. Points are bucketed in a uniform grid
+*  over the first two attributes whose cells are one tolerance wide,
+*  so the neighbors of a point all lie in the 3 x 3 block of cells
+*  around it. Each worker scans the neighborhoods of its share of the
+*  points, reporting pairs of different classes and the fraction of
+*  each point's neighbors that belong to another class (its risk of
+*  misclassification). Rows standing for several identical points
+*  are weighted by their class counts, and a row holding points of
+*  more than one class is reported paired with itself.
+*/
+class OverlapRegions {
+public:
+	// A pair of overlapping points of different classes
+	struct CrossClassPair {
+		unsigned int first;		// row id of first point
+		unsigned int second;	// row id of second point (equal to first for a mixed-class row)
+	};
+
+	/*
+	* OverlapRegions
+	* Constructor.
+	*
+	* @param	tolerances	tolerance of each attribute
+	*/
+	OverlapRegions(const std::vector<GLfloat>& tolerances) : tolerances(tolerances) {}
+
+	/*
+	* compute
+	* Find every overlapping pair of points of different classes.
+	*
+	* @param	data		view of the points to compare
+	*			classify	class of each point, by row id
+	* @return	cross-class pairs, ordered by (first, second)
+	*/
+	std::vector<CrossClassPair> compute(const DataView& data, const LabelColumn& classify)
+	{
+		return compute(data, RowCounts(classify));
+	}
+
+	/*
+	* compute
+	* Find every overlapping pair of weighted rows holding points of different classes.
+	*
+	* @param	data		view of the rows to compare
+	*			counts		class counts of each row, by row id
+	* @return	cross-class pairs, ordered by (first, second)
+	*/
+	std::vector<CrossClassPair> compute(const DataView& data, const RowCounts& counts)
+	{
+		std::vector<CrossClassPair> pairs{};
+		risk.assign(data.size(), 0.0);
+		if (data.size() == 0) return pairs;
+
+		buildGrid(data);
+
+		// Each worker scans the neighborhoods of its share of the points into its own list
+		std::vector<std::vector<CrossClassPair>> workerPairs(parallelWorkerCount());
+		parallelFor(data.size(), [&](std::size_t begin, std::size_t end, unsigned int worker)
+		{
+			ThresholdPredicate predicate(tolerances, 0.0);
+			std::vector<CrossClassPair>& found = workerPairs[worker];
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				scan(i, data, counts, &predicate, &found);
+			}
+		});
+
+		for (auto& found : workerPairs)
+		{
+			pairs.insert(pairs.end(), found.begin(), found.end());
+		}
+
+		std::sort(pairs.begin(), pairs.end(),
+			[](const CrossClassPair& lhs, const CrossClassPair& rhs)
+			{ return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second); });
+
+		return pairs;
+	}
+
+	// Get the risk of each point of the last computed view, in [0, 1]
+	const std::vector<GLfloat>& getRisk() const { return risk; }
+
+private:
+
+	// Bucket every point of the view by its grid cell
+	void buildGrid(const DataView& data)
+	{
+		dimension = data[0].size();
+		for (std::size_t axis = 0; axis < 2; ++axis)
+		{
+			GLfloat tolerance = (axis < tolerances.size() && axis < dimension) ? tolerances[axis] : 0.0f;
+			cellWidth[axis] = (tolerance > 0.0) ? tolerance : 1.0f;
+			cellSpan[axis] = (tolerance > 0.0) ? 1 : 0;
+		}
+
+		// Sort points by cell so each cell is a contiguous range of the order
+		std::vector<long long> keys(data.size());
+		order.resize(data.size());
+		for (unsigned int i = 0; i < order.size(); ++i)
+		{
+			keys[i] = cellKey(cellOf(data[i], 0), cellOf(data[i], 1));
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&](unsigned int lhs, unsigned int rhs) { return keys[lhs] < keys[rhs]; });
+
+		cells.clear();
+		for (std::size_t start = 0; start < order.size(); )
+		{
+			std::size_t stop = start;
+			while (stop < order.size() && keys[order[stop]] == keys[order[start]]) ++stop;
+			cells[keys[order[start]]] = std::make_pair((unsigned int)start, (unsigned int)stop);
+			start = stop;
+		}
+	}
+
+	// Compare point i to every point in the surrounding cells
+	void scan(std::size_t i, const DataView& data, const RowCounts& counts,
+		ThresholdPredicate* predicate, std::vector<CrossClassPair>* found)
+	{
+		RowView center = data[i];
+		predicate->compile(center.data, center.size());
+		unsigned int centerId = data.id(i);
+		ClassLabel centerClass = counts.dominant(centerId);
+		bool centerPure = counts.count(centerId, centerClass) == counts.weight(centerId);
+
+		long long cellX = cellOf(center, 0);
+		long long cellY = cellOf(center, 1);
+
+		// Other points of the center row are its closest neighbors
+		unsigned int neighbors = counts.weight(centerId) - 1;
+		unsigned int crossClass = counts.weight(centerId) - counts.count(centerId, centerClass);
+		if (!centerPure) found->push_back({ centerId, centerId });
+
+		for (long long x = cellX - cellSpan[0]; x <= cellX + cellSpan[0]; ++x)
+		{
+			for (long long y = cellY - cellSpan[1]; y <= cellY + cellSpan[1]; ++y)
+			{
+				auto cell = cells.find(cellKey(x, y));
+				if (cell == cells.end()) continue;
+
+				for (unsigned int k = cell->second.first; k < cell->second.second; ++k)
+				{
+					unsigned int j = order[k];
+					if (j == i) continue;
+
+					RowView other = data[j];
+					if (!predicate->contains(other.data, std::min(dimension, other.size()))) continue;
+
+					unsigned int otherId = data.id(j);
+					unsigned int sameClass = counts.count(otherId, centerClass);
+					neighbors += counts.weight(otherId);
+					crossClass += counts.weight(otherId) - sameClass;
+
+					// Rows differ in class unless both hold only points of the center class
+					bool mixed = !centerPure || sameClass != counts.weight(otherId);
+					if (mixed && j > i) found->push_back({ centerId, otherId });
+				}
+			}
+		}
+
+		risk[i] = (neighbors > 0) ? (GLfloat)crossClass / neighbors : 0.0f;
+	}
+
+	long long cellOf(const RowView& point, std::size_t axis) const
+	{
+		return (axis < point.size()) ? (long long)std::floor(point[axis] / cellWidth[axis]) : 0;
+	}
+
+	long long cellKey(long long x, long long y) const { return (x << 32) ^ (y & 0xFFFFFFFF); }
+
+	std::vector<GLfloat> tolerances{};		// tolerance of each attribute
+	std::size_t dimension = 0;				// attributes per point
+	GLfloat cellWidth[2] = { 1.0, 1.0 };	// grid cell width on each indexed attribute
+	long long cellSpan[2] = { 1, 1 };		// cells searched either side of a point
+	std::vector<unsigned int> order{};		// point indices sorted by cell
+	std::unordered_map<long long, std::pair<unsigned int, unsigned int>> cells{};	// range of order in each cell
+	std::vector<GLfloat> risk{};			// cross-class fraction of each point's neighbors
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+/*
+* parallelWorkerCount
+* Number of worker threads used by the parallel
+* analysis stages. Falls back to one thread when the
+* hardware concurrency cannot be determined.
+*
+* @return	unsigned int	number of workers
+*/
+inline unsigned int parallelWorkerCount()
+{
+	unsigned int workers = std::thread::hardware_concurrency();
+	return (workers == 0) ? 1 : workers;
+}
+
+/*
+* parallelFor
+* Split the range [0, count) into contiguous chunks and
+* run body(begin, end, worker) on each chunk in its own
+* thread. The calling thread processes the last chunk.
+*
+* @param	count	number of items to process
+*			body	callable taking (begin, end, worker)
+*/
+template <typename Body>
+void parallelFor(std::size_t count, Body body)
+{
+	if (count == 0) return;
+
+	std::size_t workers = std::min<std::size_t>(parallelWorkerCount(), count);
+	std::size_t chunk = (count + workers - 1) / workers;
+	workers = (count + chunk - 1) / chunk;	// drop workers left without items
+
+	std::vector<std::thread> threads{};
+	for (std::size_t worker = 0; worker + 1 < workers; ++worker)
+	{
+		std::size_t begin = worker * chunk;
+		std::size_t end = std::min(count, begin + chunk);
+		threads.emplace_back(body, begin, end, (unsigned int)worker);
+	}
+
+	// Run the final chunk on the calling thread
+	body((workers - 1) * chunk, count, (unsigned int)(workers - 1));
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+}
@@ -0,0 +1,258 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "GL/glut.h"
+#include "classlabels.h"
+#include "dataview.h"
+#include "densitymap.h"
+#include "parallel.h"
+#include "vertexbatch.h"
+
+/* ParallelCoordinates: parallel coordinates of any number of dimensions
+*  Rows are kept as one column per dimension, and axes are drawn in
+*  a user order that only permutes the columns, so reordering never
+*  touches the rows. Each row is drawn as a polyline through a
+*  VertexBatch, or, for rows too many to draw one by one, the view
+*  is binned: every pair of dimensions holds a 2-D histogram per
+*  class, and each filled bin is one weighted line between adjacent
+*  axes, splatted into a DensityMap. A row stands for as many data
+*  points as its weight, which it adds to its bins and which
+*  deepens the opacity of its polyline. Histograms are computed on first
+*  use of a pair and kept until the rows change, so reordering only
+*  bins pairs that were never adjacent before.
+*/
+class ParallelCoordinates {
+public:
+	/*
+	* setRows
+	* Take the rows to show. Histograms are kept if the rows, their
+	* classes, weights and the selection are the same as in the
+	* previous call.
+	*
+	* @param	data		rows normalized to [0, 1], one value per dimension
+	*			labels		class of each row
+	*			weights		number of data points of each row
+	*			selected	rows to show
+	*			numClasses	number of classes
+	*/
+	void setRows(const DataView& data, const std::vector<ClassLabel>& labels, const std::vector<unsigned int>& weights,
+		const std::vector<bool>& selected, std::size_t numClasses)
+	{
+		std::size_t dimensions = (data.size() == 0) ? 0 : data[0].size();
+		bool changed = dimensions != numDimensions || data.size() != numRows || numClasses != this->numClasses;
+		if (changed)
+		{
+			numDimensions = dimensions;
+			numRows = data.size();
+			this->numClasses = numClasses;
+			columns.assign(numDimensions, std::vector<GLfloat>(numRows, 0.0f));
+			rowLabels.assign(numRows, 0);
+			rowWeights.assign(numRows, 1);
+			rowSelected.assign(numRows, false);
+			if (order.size() != numDimensions)
+			{
+				order.resize(numDimensions);
+				for (unsigned int i = 0; i < numDimensions; ++i) order[i] = i;
+			}
+		}
+
+		for (std::size_t r = 0; r < numRows; ++r)
+		{
+			RowView row = data[r];
+			for (std::size_t d = 0; d < numDimensions; ++d)
+			{
+				GLfloat value = (d < row.size()) ? row[d] : 0.0f;
+				changed = changed || columns[d][r] != value;
+				columns[d][r] = value;
+			}
+			ClassLabel label = (r < labels.size()) ? labels[r] : 0;
+			unsigned int weight = (r < weights.size()) ? weights[r] : 1;
+			bool show = r < selected.size() && selected[r];
+			changed = changed || rowLabels[r] != label || rowWeights[r] != weight || rowSelected[r] != show;
+			rowLabels[r] = label;
+			rowWeights[r] = weight;
+			rowSelected[r] = show;
+		}
+
+		if (changed) histograms.assign(numDimensions * numDimensions, std::vector<float>{});
+	}
+
+	// Number of dimensions, and so of axes
+	std::size_t getNumDimensions() const { return numDimensions; }
+
+	// Dimension shown on each axis, from left to right
+	const std::vector<unsigned int>& getOrder() const { return order; }
+
+	/*
+	* moveAxis
+	* Swap an axis with its neighbor.
+	*
+	* @param	position	position of the axis, from the left
+	*			step		-1 to move it left, 1 to move it right
+	* @return				new position of the axis
+	*/
+	std::size_t moveAxis(std::size_t position, int step)
+	{
+		std::size_t target = position + step;
+		if (position >= numDimensions || target >= numDimensions) return position;
+		std::swap(order[position], order[target]);
+		return target;
+	}
+
+	// Set the number of bins along each axis in the binned view
+	void setBins(unsigned int bins)
+	{
+		bins = std::max(1u, bins);
+		if (bins == this->bins) return;
+		this->bins = bins;
+		histograms.assign(numDimensions * numDimensions, std::vector<float>{});
+	}
+
+	// Window x of the axis at a position
+	GLfloat axisX(std::size_t position, int width) const
+	{
+		if (numDimensions < 2) return 0.0f;
+		return (GLfloat)(position * (width / (numDimensions - 1)));
+	}
+
+	/*
+	* addAxes
+	* Add a vertical line per axis to a batch in window coordinates.
+	*
+	* @param	batch			batch to add the axes to
+	*			width, height	window size in pixels
+	*			highlighted		position of the axis drawn in gray
+	*/
+	void addAxes(VertexBatch* batch, int width, int height, std::size_t highlighted) const
+	{
+		batch->setWindow();
+		for (std::size_t position = 0; position < numDimensions; ++position)
+		{
+			GLfloat shade = (position == highlighted) ? 0.5f : 0.0f;
+			batch->setColor(shade, shade, shade, 1.0);
+			batch->addLine(axisX(position, width), 0.0, axisX(position, width), (GLfloat)height);
+		}
+	}
+
+	/*
+	* addLines
+	* Add the polyline of every selected row to a batch in window
+	* coordinates. A row of weight w is as opaque as w lines drawn
+	* over each other.
+	*
+	* @param	batch			batch to add the lines to
+	*			width, height	window size in pixels
+	*			palette			red, green and blue of each class
+	*			alpha			opacity of a line of weight 1
+	*/
+	void addLines(VertexBatch* batch, int width, int height, const std::vector<GLfloat>& palette, GLfloat alpha) const
+	{
+		batch->setWindow();
+		for (std::size_t r = 0; r < numRows; ++r)
+		{
+			if (!rowSelected[r]) continue;
+			const GLfloat* color = &palette[3 * rowLabels[r]];
+			batch->setColor(color[0], color[1], color[2], 1.0f - std::pow(1.0f - alpha, (GLfloat)rowWeights[r]));
+			for (std::size_t position = 0; position + 1 < numDimensions; ++position)
+			{
+				batch->addLine(axisX(position, width), height * columns[order[position]][r],
+					axisX(position + 1, width), height * columns[order[position + 1]][r]);
+			}
+		}
+	}
+
+	/*
+	* accumulateDensity
+	* Splat the binned lines between every pair of adjacent axes into
+	* a density map covering the window.
+	*
+	* @param	density			density map sized to the window and classes
+	*			width, height	window size in pixels
+	*/
+	void accumulateDensity(DensityMap* density, int width, int height)
+	{
+		std::vector<DensityMap::Splat> lines{};
+		for (std::size_t position = 0; position + 1 < numDimensions; ++position)
+		{
+			unsigned int left = order[position];
+			unsigned int right = order[position + 1];
+			const std::vector<float>& histogram = pairHistogram(std::min(left, right), std::max(left, right));
+			bool swapped = left > right;
+
+			int x0 = (int)axisX(position, width);
+			int x1 = (int)axisX(position + 1, width);
+			for (std::size_t c = 0; c < numClasses; ++c)
+			{
+				for (unsigned int i = 0; i < bins; ++i)
+				{
+					for (unsigned int j = 0; j < bins; ++j)
+					{
+						float count = histogram[(c * bins + i) * bins + j];
+						if (count == 0.0f) continue;
+						int y0 = binY(swapped ? j : i, height);
+						int y1 = binY(swapped ? i : j, height);
+						lines.push_back({ (ClassLabel)c, x0, y0, x1, y1, count });
+					}
+				}
+			}
+		}
+		density->accumulateLines(lines);
+	}
+
+private:
+
+	// Histogram of a pair of dimensions (first < second), computed on first use
+	const std::vector<float>& pairHistogram(unsigned int first, unsigned int second)
+	{
+		std::vector<float>& histogram = histograms[first * numDimensions + second];
+		if (!histogram.empty()) return histogram;
+
+		// Each worker bins the weights of its own rows, then the counts are summed
+		std::size_t cells = numClasses * bins * bins;
+		std::vector<std::vector<float>> workerCounts(parallelWorkerCount());
+		parallelFor(numRows, [&](std::size_t begin, std::size_t end, unsigned int worker)
+		{
+			std::vector<float>& counts = workerCounts[worker];
+			counts.assign(cells, 0.0f);
+			for (std::size_t r = begin; r < end; ++r)
+			{
+				if (!rowSelected[r]) continue;
+				unsigned int i = bin(columns[first][r]);
+				unsigned int j = bin(columns[second][r]);
+				counts[(rowLabels[r] * bins + i) * bins + j] += rowWeights[r];
+			}
+		});
+
+		histogram.assign(cells, 0.0f);
+		for (const auto& counts : workerCounts)
+		{
+			for (std::size_t cell = 0; cell < counts.size(); ++cell) histogram[cell] += counts[cell];
+		}
+		return histogram;
+	}
+
+	// Bin of a value in [0, 1]
+	unsigned int bin(GLfloat value) const
+	{
+		int b = (int)(value * bins);
+		return (unsigned int)std::min(std::max(b, 0), (int)bins - 1);
+	}
+
+	// Window y of the center of a bin
+	int binY(unsigned int b, int height) const
+	{
+		return (int)((b + 0.5f) * height / bins);
+	}
+
+	std::size_t numDimensions = 0;					// number of dimensions
+	std::size_t numRows = 0;						// number of rows
+	std::size_t numClasses = 0;						// number of classes
+	unsigned int bins = 64;							// bins along each axis in the binned view
+	std::vector<std::vector<GLfloat>> columns{};	// value of each row, per dimension
+	std::vector<ClassLabel> rowLabels{};			// class of each row
+	std::vector<unsigned int> rowWeights{};			// data points of each row
+	std::vector<bool> rowSelected{};				// rows shown
+	std::vector<unsigned int> order{};				// dimension of each axis, from left to right
+	std::vector<std::vector<float>> histograms{};	// counts per class and bin pair, per dimension pair (empty until used)
+};
@@ -0,0 +1,210 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <algorithm>
+#include "GL/glut.h"
+
+/* PngWriter: RGB images written as PNG files without external libraries
+*  Each row is stored with the PNG "up" filter, so the flat areas
+*  and repeated rows of a rendered view become runs of zeros, and the
+*  filtered rows are deflated with greedy LZ77 matching (one hash
+*  entry per 3-byte prefix) and the fixed Huffman codes. That is far
+*  from the best compression, but rendered views shrink by well over
+*  an order of magnitude at little cost.
+*/
+class PngWriter {
+public:
+	/*
+	* write
+	* Write an RGB image to a PNG file.
+	*
+	* @param	path			file to write
+	*			width, height	image size in pixels
+	*			rgb				three bytes per pixel, rows from the bottom up as read by glReadPixels
+	* @return					true if the file was written
+	*/
+	static bool write(const std::string& path, int width, int height, const std::vector<GLubyte>& rgb)
+	{
+		if (width <= 0 || height <= 0 || rgb.size() < (std::size_t)width * height * 3) return false;
+
+		// Filter the rows top-down, each as the difference from the row above
+		std::size_t stride = (std::size_t)width * 3;
+		std::vector<std::uint8_t> filtered{};
+		filtered.reserve((stride + 1) * height);
+		for (int row = 0; row < height; ++row)
+		{
+			const GLubyte* line = &rgb[(height - 1 - row) * stride];
+			const GLubyte* above = (row > 0) ? &rgb[(height - row) * stride] : nullptr;
+			filtered.push_back(2);	// "up" filter
+			for (std::size_t i = 0; i < stride; ++i) filtered.push_back((std::uint8_t)(line[i] - (above ? above[i] : 0)));
+		}
+
+		std::vector<std::uint8_t> header{};
+		putBig(&header, (std::uint32_t)width);
+		putBig(&header, (std::uint32_t)height);
+		header.push_back(8);	// bits per channel
+		header.push_back(2);	// RGB
+		header.push_back(0);	// deflate
+		header.push_back(0);	// adaptive filtering
+		header.push_back(0);	// no interlace
+
+		std::vector<std::uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		putChunk(&png, "IHDR", header);
+		putChunk(&png, "IDAT", zlib(filtered));
+		putChunk(&png, "IEND", std::vector<std::uint8_t>{});
+
+		std::ofstream file(path, std::ios::binary);
+		file.write((const char*)png.data(), png.size());
+		return (bool)file;
+	}
+
+private:
+
+	// Bits written least significant first, as deflate packs them
+	struct BitWriter {
+		std::vector<std::uint8_t>* out;
+		std::uint32_t buffer = 0;
+		unsigned int count = 0;
+
+		void put(std::uint32_t bits, unsigned int length)
+		{
+			buffer |= bits << count;
+			count += length;
+			while (count >= 8)
+			{
+				out->push_back((std::uint8_t)buffer);
+				buffer >>= 8;
+				count -= 8;
+			}
+		}
+
+		// Put a Huffman code, which deflate packs most significant bit first
+		void putCode(std::uint32_t code, unsigned int length)
+		{
+			std::uint32_t reversed = 0;
+			for (unsigned int i = 0; i < length; ++i) reversed |= ((code >> i) & 1) << (length - 1 - i);
+			put(reversed, length);
+		}
+
+		void flush()
+		{
+			if (count > 0) out->push_back((std::uint8_t)buffer);
+			buffer = 0;
+			count = 0;
+		}
+	};
+
+	// Put a literal or length symbol in the fixed Huffman code
+	static void putSymbol(BitWriter* bits, unsigned int symbol)
+	{
+		if (symbol < 144)		bits->putCode(0x30 + symbol, 8);
+		else if (symbol < 256)	bits->putCode(0x190 + symbol - 144, 9);
+		else if (symbol < 280)	bits->putCode(symbol - 256, 7);
+		else					bits->putCode(0xC0 + symbol - 280, 8);
+	}
+
+	// Put a match of a length in [3, 258] at a distance in [1, 32768]
+	static void putMatch(BitWriter* bits, unsigned int length, unsigned int distance)
+	{
+		static const unsigned short lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+			35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		static const unsigned char lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+			3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		static const unsigned short distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+			257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		static const unsigned char distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+			7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+		unsigned int l = 28;
+		while (lengthBase[l] > length) --l;
+		putSymbol(bits, 257 + l);
+		bits->put(length - lengthBase[l], lengthExtra[l]);
+
+		unsigned int d = 29;
+		while (distanceBase[d] > distance) --d;
+		bits->putCode(d, 5);
+		bits->put(distance - distanceBase[d], distanceExtra[d]);
+	}
+
+	// Compress data into a zlib stream of one fixed Huffman block
+	static std::vector<std::uint8_t> zlib(const std::vector<std::uint8_t>& data)
+	{
+		std::vector<std::uint8_t> out = { 0x78, 0x01 };
+		BitWriter bits{ &out };
+		bits.put(1, 1);		// final block
+		bits.put(1, 2);		// fixed Huffman codes
+
+		const std::size_t window = 32768;
+		const unsigned int hashBits = 15;
+		std::vector<std::int64_t> last((std::size_t)1 << hashBits, -1);	// latest position of each 3-byte hash
+		std::size_t i = 0;
+		while (i < data.size())
+		{
+			unsigned int length = 0;
+			std::size_t distance = 0;
+			if (i + 3 <= data.size())
+			{
+				std::uint32_t hash = ((data[i] << 16) | (data[i + 1] << 8) | data[i + 2]) * 2654435761u >> (32 - hashBits);
+				std::int64_t candidate = last[hash];
+				last[hash] = (std::int64_t)i;
+				if (candidate >= 0 && i - candidate <= window)
+				{
+					std::size_t limit = std::min<std::size_t>(258, data.size() - i);
+					while (length < limit && data[candidate + length] == data[i + length]) ++length;
+					distance = i - candidate;
+				}
+			}
+
+			if (length >= 3)
+			{
+				putMatch(&bits, length, (unsigned int)distance);
+				i += length;
+			}
+			else
+			{
+				putSymbol(&bits, data[i]);
+				++i;
+			}
+		}
+		putSymbol(&bits, 256);	// end of block
+		bits.flush();
+
+		// Adler-32 of the uncompressed data
+		std::uint32_t a = 1, b = 0;
+		for (std::uint8_t byte : data)
+		{
+			a = (a + byte) % 65521;
+			b = (b + a) % 65521;
+		}
+		putBig(&out, (b << 16) | a);
+		return out;
+	}
+
+	// CRC-32 of a chunk's type and data
+	static std::uint32_t crc(const std::vector<std::uint8_t>& bytes)
+	{
+		std::uint32_t c = 0xFFFFFFFFu;
+		for (std::uint8_t byte : bytes)
+		{
+			c ^= byte;
+			for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+		}
+		return c ^ 0xFFFFFFFFu;
+	}
+
+	static void putBig(std::vector<std::uint8_t>* out, std::uint32_t value)
+	{
+		for (int shift = 24; shift >= 0; shift -= 8) out->push_back((std::uint8_t)(value >> shift));
+	}
+
+	static void putChunk(std::vector<std::uint8_t>* out, const char* type, const std::vector<std::uint8_t>& data)
+	{
+		putBig(out, (std::uint32_t)data.size());
+		std::vector<std::uint8_t> typed(type, type + 4);
+		typed.insert(typed.end(), data.begin(), data.end());
+		out->insert(out->end(), typed.begin(), typed.end());
+		putBig(out, crc(typed));
+	}
+};
@@ -0,0 +1,287 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include "GL/glut.h"
+
+/* Point<D>: a fixed-dimension data point
+*  The dimension counts used by the data sets are small and known
+*  (5 for seeds, 9 for WBC, 10 for students), so rows are packed into
+*  std::array for the hot comparison loops. With D known at compile
+*  time the kernels below are fully unrolled and never allocate.
+*/
+template <std::size_t D>
+using Point = std::array<GLfloat, D>;
+
+// Pack a row into a fixed-dimension point (missing attributes are zero)
+template <std::size_t D>
+Point<D> toPoint(const std::vector<GLfloat>& row)
+{
+	Point<D> point{};
+	for (std::size_t i = 0; i < D && i < row.size(); ++i)
+	{
+		point[i] = row[i];
+	}
+	return point;
+}
+
+// Check that every attribute of b is within the per-attribute threshold of a
+template <std::size_t D>
+bool isCloseD(const Point<D>& a, const Point<D>& b, const Point<D>& threshold)
+{
+	bool close = true;
+	for (std::size_t i = 0; i < D; ++i)
+	{
+		close &= std::abs(a[i] - b[i]) <= threshold[i];
+	}
+	return close;
+}
+
+// Check that every attribute of p lies within precomputed [lower, upper] bounds
+template <std::size_t D>
+bool withinBoundsD(const Point<D>& p, const Point<D>& lower, const Point<D>& upper)
+{
+	bool inside = true;
+	for (std::size_t i = 0; i < D; ++i)
+	{
+		inside &= std::min(std::max(p[i], lower[i]), upper[i]) == p[i];
+	}
+	return inside;
+}
+
+// Squared Euclidean distance between two points
+template <std::size_t D>
+GLfloat squaredDistanceD(const Point<D>& a, const Point<D>& b)
+{
+	GLfloat sum = 0.0;
+	for (std::size_t i = 0; i < D; ++i)
+	{
+		GLfloat diff = a[i] - b[i];
+		sum += diff * diff;
+	}
+	return sum;
+}
+
+// Average of the points selected by ids
+template <std::size_t D>
+Point<D> centroidD(const std::vector<Point<D>>& points, const std::vector<unsigned int>& ids)
+{
+	Point<D> sum{};
+	for (unsigned int id : ids)
+	{
+		for (std::size_t i = 0; i < D; ++i)
+		{
+			sum[i] += points[id][i];
+		}
+	}
+	for (std::size_t i = 0; i < D; ++i)
+	{
+		sum[i] /= ids.size();
+	}
+	return sum;
+}
+
+// Average of the points selected by ids, each counted weights[id] times
+template <std::size_t D>
+Point<D> weightedCentroidD(const std::vector<Point<D>>& points, const std::vector<unsigned int>& ids,
+	const std::vector<unsigned int>& weights)
+{
+	Point<D> sum{};
+	GLfloat total = 0.0;
+	for (unsigned int id : ids)
+	{
+		for (std::size_t i = 0; i < D; ++i)
+		{
+			sum[i] += points[id][i] * weights[id];
+		}
+		total += weights[id];
+	}
+	for (std::size_t i = 0; i < D; ++i)
+	{
+		sum[i] /= total;
+	}
+	return sum;
+}
+
+/* RowKernels: neighborhood, distance and centroid kernels over a data set
+*  A kernel object is built once per data set by makeRowKernels, which
+*  dispatches on the runtime dimension a single time. Each call then
+*  runs a whole scan inside the dimension-specialized implementation.
+*/
+class RowKernels {
+public:
+	virtual ~RowKernels() {}
+
+	/*
+	* closeTo
+	* Mark which of the rows in ids are within threshold of the center row.
+	*
+	* @param	center	id of the center row
+	*			ids		ids of the rows to test
+	*			close	output mask, one entry per id
+	*/
+	virtual void closeTo(unsigned int center, const std::vector<unsigned int>& ids, std::vector<bool>* close) = 0;
+
+	// Euclidean distance between two rows
+	virtual GLfloat distance(unsigned int first, unsigned int second) = 0;
+
+	// Average of the rows in ids, written to the first D attributes of out
+	virtual void centroid(const std::vector<unsigned int>& ids, std::vector<GLfloat>* out) = 0;
+
+	// Average of the rows in ids, each counted weights[id] times
+	virtual void weightedCentroid(const std::vector<unsigned int>& ids, const std::vector<unsigned int>& weights,
+		std::vector<GLfloat>* out) = 0;
+};
+
+// Kernels specialized for a fixed dimension D
+template <std::size_t D>
+class FixedRowKernels : public RowKernels {
+public:
+	// Constructor: pack every row and the thresholds once
+	FixedRowKernels(const std::vector<std::vector<GLfloat>>& rows, const std::vector<GLfloat>& thresholds)
+	{
+		points.reserve(rows.size());
+		for (const auto& row : rows)
+		{
+			points.push_back(toPoint<D>(row));
+		}
+		threshold = toPoint<D>(thresholds);
+	}
+
+	void closeTo(unsigned int center, const std::vector<unsigned int>& ids, std::vector<bool>* close)
+	{
+		// Compile the neighborhood of the center into bounds once
+		Point<D> lower{};
+		Point<D> upper{};
+		for (std::size_t attr = 0; attr < D; ++attr)
+		{
+			lower[attr] = points[center][attr] - threshold[attr];
+			upper[attr] = points[center][attr] + threshold[attr];
+		}
+
+		close->resize(ids.size());
+		for (std::size_t i = 0; i < ids.size(); ++i)
+		{
+			(*close)[i] = withinBoundsD<D>(points[ids[i]], lower, upper);
+		}
+	}
+
+	GLfloat distance(unsigned int first, unsigned int second)
+	{
+		return std::sqrt(squaredDistanceD<D>(points[first], points[second]));
+	}
+
+	void centroid(const std::vector<unsigned int>& ids, std::vector<GLfloat>* out)
+	{
+		Point<D> center = centroidD<D>(points, ids);
+		out->assign(center.begin(), center.end());
+	}
+
+	void weightedCentroid(const std::vector<unsigned int>& ids, const std::vector<unsigned int>& weights,
+		std::vector<GLfloat>* out)
+	{
+		Point<D> center = weightedCentroidD<D>(points, ids, weights);
+		out->assign(center.begin(), center.end());
+	}
+
+private:
+	std::vector<Point<D>> points{};		// packed rows
+	Point<D> threshold{};				// per-attribute threshold
+};
+
+// Fallback kernels for dimensions without a specialization
+class DynamicRowKernels : public RowKernels {
+public:
+	// Constructor
+	DynamicRowKernels(const std::vector<std::vector<GLfloat>>& rows, const std::vector<GLfloat>& thresholds)
+		: rows(&rows), threshold(thresholds) {}
+
+	void closeTo(unsigned int center, const std::vector<unsigned int>& ids, std::vector<bool>* close)
+	{
+		const std::vector<GLfloat>& centerRow = (*rows)[center];
+		close->resize(ids.size());
+		for (std::size_t i = 0; i < ids.size(); ++i)
+		{
+			const std::vector<GLfloat>& row = (*rows)[ids[i]];
+			bool isClose = true;
+			for (std::size_t attr = 0; attr < centerRow.size() && attr < threshold.size(); ++attr)
+			{
+				isClose &= std::abs(centerRow[attr] - row[attr]) <= threshold[attr];
+			}
+			(*close)[i] = isClose;
+		}
+	}
+
+	GLfloat distance(unsigned int first, unsigned int second)
+	{
+		GLfloat sum = 0.0;
+		for (std::size_t attr = 0; attr < (*rows)[first].size(); ++attr)
+		{
+			GLfloat diff = (*rows)[first][attr] - (*rows)[second][attr];
+			sum += diff * diff;
+		}
+		return std::sqrt(sum);
+	}
+
+	void centroid(const std::vector<unsigned int>& ids, std::vector<GLfloat>* out)
+	{
+		out->assign((*rows)[ids.front()].size(), 0.0);
+		for (unsigned int id : ids)
+		{
+			for (std::size_t attr = 0; attr < out->size(); ++attr)
+			{
+				(*out)[attr] += (*rows)[id][attr];
+			}
+		}
+		for (auto& attr : *out)
+		{
+			attr /= ids.size();
+		}
+	}
+
+	void weightedCentroid(const std::vector<unsigned int>& ids, const std::vector<unsigned int>& weights,
+		std::vector<GLfloat>* out)
+	{
+		out->assign((*rows)[ids.front()].size(), 0.0);
+		GLfloat total = 0.0;
+		for (unsigned int id : ids)
+		{
+			for (std::size_t attr = 0; attr < out->size(); ++attr)
+			{
+				(*out)[attr] += (*rows)[id][attr] * weights[id];
+			}
+			total += weights[id];
+		}
+		for (auto& attr : *out)
+		{
+			attr /= total;
+		}
+	}
+
+private:
+	const std::vector<std::vector<GLfloat>>* rows;	// unpacked rows
+	std::vector<GLfloat> threshold;					// per-attribute threshold
+};
+
+/*
+* makeRowKernels
+* Build the kernels for a data set, dispatching once on its dimension.
+*
+* @param	rows		data set, all rows of equal dimension
+*			thresholds	per-attribute neighborhood threshold
+* @return	kernels specialized for the dimension of the rows
+*/
+inline std::unique_ptr<RowKernels> makeRowKernels(const std::vector<std::vector<GLfloat>>& rows,
+	const std::vector<GLfloat>& thresholds)
+{
+	std::size_t dimension = rows.empty() ? 0 : rows.front().size();
+	switch (dimension)
+	{
+	case 5:		return std::unique_ptr<RowKernels>(new FixedRowKernels<5>(rows, thresholds));		// seeds
+	case 9:		return std::unique_ptr<RowKernels>(new FixedRowKernels<9>(rows, thresholds));		// WBC
+	case 10:	return std::unique_ptr<RowKernels>(new FixedRowKernels<10>(rows, thresholds));		// students, 2 x seeds
+	default:	return std::unique_ptr<RowKernels>(new DynamicRowKernels(rows, thresholds));
+	}
+}
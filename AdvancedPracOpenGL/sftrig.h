@@ -0,0 +1,112 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include "GL/glut.h"
+
+/* AngleMap: linear mapping of data values to SF angles in degrees
+*  Maps the data range [rmin, rmax] onto the angle range
+*  [tmin, tmax] with a precomputed scale and offset.
+*/
+struct AngleMap {
+	GLfloat scale = 1.0;	// degrees per data unit
+	GLfloat offset = 0.0;	// degrees at a data value of 0
+
+	// Constructor
+	AngleMap(GLfloat rmin, GLfloat rmax, GLfloat tmin, GLfloat tmax)
+	{
+		scale = (tmax - tmin) / (rmax - rmin);
+		offset = tmin - rmin * scale;
+	}
+
+	// Angle in degrees of a data value
+	GLfloat degrees(GLfloat value) const { return value * scale + offset; }
+};
+
+/*
+* sinCosBatch
+* Sine and cosine of many angles at once. Angles are reduced to
+* [-pi/4, pi/4] by quarter turns and evaluated with minimax
+* polynomials, using only arithmetic and selects so the loop
+* vectorizes. Accurate to a few float ulps for angles within a
+* few turns of zero.
+*
+* @param	radians		angles in radians
+*			count		number of angles
+*			sines		output sines
+*			cosines		output cosines
+*/
+inline void sinCosBatch(const GLfloat* radians, std::size_t count, GLfloat* sines, GLfloat* cosines)
+{
+	const float twoOverPi = 0.636619772f;
+	const float halfPiHigh = 1.5703125f;			// pi/2 split in three parts for exact reduction
+	const float halfPiMid = 4.83751297e-4f;
+	const float halfPiLow = 7.54978995e-8f;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		float x = radians[i];
+		float turns = x * twoOverPi;
+		int quarter = (int)(turns + ((turns < 0.0f) ? -0.5f : 0.5f));	// nearest quarter turn, rounded without floor so the loop vectorizes
+		float k = (float)quarter;
+		float r = ((x - k * halfPiHigh) - k * halfPiMid) - k * halfPiLow;
+		float r2 = r * r;
+
+		// sin and cos of the reduced angle
+		float s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+		float c = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+		// Rotate by the quarter turns: quadrant 1 swaps, quadrants 1 and 2 negate
+		int quadrant = quarter & 3;
+		float swappedSin = (quadrant & 1) ? c : s;
+		float swappedCos = (quadrant & 1) ? s : c;
+		sines[i] = (quadrant & 2) ? -swappedSin : swappedSin;
+		cosines[i] = ((quadrant + 1) & 2) ? -swappedCos : swappedCos;
+	}
+}
+
+/* SinCosTable: sine and cosine of the SF angles of quantized data values
+*  Data values on a grid of levels steps over [0, 1] (as in the WBC
+*  data, normalized from 1 - 10) map to a handful of angles whose
+*  sines and cosines are computed once. Values off the grid are
+*  reported so they can go through sinCosBatch instead.
+*/
+class SinCosTable {
+public:
+	/*
+	* SinCosTable
+	* Constructor.
+	*
+	* @param	map			mapping of data values to degrees
+	*			radiansPerDegree	conversion factor used by the turtle
+	*			levels		number of steps of the data grid over [0, 1]
+	*/
+	SinCosTable(const AngleMap& map, GLfloat radiansPerDegree, unsigned int levels = 10) : levels(levels)
+	{
+		for (unsigned int i = 0; i <= levels; ++i)
+		{
+			GLfloat radians = radiansPerDegree * map.degrees((GLfloat)i / levels);
+			sines.push_back(std::sin(radians));
+			cosines.push_back(std::cos(radians));
+		}
+	}
+
+	// Index of a data value on the grid, or -1 if it is off the grid
+	int index(GLfloat value) const
+	{
+		GLfloat scaled = value * levels;
+		GLfloat nearest = std::floor(scaled + 0.5f);
+		if (std::abs(scaled - nearest) > 1e-4f || nearest < 0.0f || nearest > (GLfloat)levels) return -1;
+		return (int)nearest;
+	}
+
+	// Sine of the angle of a grid index
+	GLfloat sine(int i) const { return sines[i]; }
+
+	// Cosine of the angle of a grid index
+	GLfloat cosine(int i) const { return cosines[i]; }
+
+private:
+	unsigned int levels;			// steps of the data grid over [0, 1]
+	std::vector<GLfloat> sines{};	// sine of each grid value's angle
+	std::vector<GLfloat> cosines{};	// cosine of each grid value's angle
+};
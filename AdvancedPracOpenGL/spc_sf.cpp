@@ -30,12 +30,38 @@
 #include "GL/glut.h"	/*  */
 #include "turtleg.h"	/*  */
 #include "spc_sf.h"		/*  */
+#include "hyperblock.h"	/*  */
+#include "hyperblockmodel.h"	/*  */
+#include "pointd.h"		/*  */
+#include "thresholdpredicate.h"	/*  */
+#include "dataview.h"	/*  */
+#include "classstats.h"	/*  */
+#include "classlabels.h"	/*  */
+#include "overlapregion.h"	/*  */
+#include "dedup.h"		/*  */
+#include "glyphmapping.h"	/*  */
+#include "mappingoptimizer.h"	/*  */
+#include "cluttermetric.h"	/*  */
+#include "glyphgeometry.h"	/*  */
+#include "glyphrenderer.h"	/*  */
+#include "backgroundlayer.h"	/*  */
+#include "glyphlod.h"		/*  */
+#include "densitymap.h"	/*  */
+#include "parallelcoords.h"	/*  */
+#include "hyperblockenvelope.h"	/*  */
+#include "decisiontree.h"	/*  */
+#include "edgebundling.h"	/*  */
+#include "headless.h"		/*  */
+#include "pngwriter.h"		/*  */
+#include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
 #include <random>
 #include <queue>
+#include <limits>
+#include <cstdlib>
 
 int sumx1 = 0;
 int sumy1 = 0;
@@ -53,6 +79,10 @@ float maxX = 10.0;
 float minY = 10.0;
 
 std::vector<std::vector<GLfloat>> analyzeGlyphs{};
+std::vector<ClassLabel> analyzeClass{};							/* class of each analyzed glyph */
+std::vector<GLfloat> analyzeRisk{};								/* misclassification risk of each analyzed glyph */
+std::vector<OverlapRegions::CrossClassPair> analyzePairs{};		/* overlapping points of different classes */
+bool ANALYZE_COLLECTED = false;									/* flag if analyzed glyphs have already been collected */
 
 bool SIZE_VIEW = false;
 int FLOCK_LENGTH = 2;
@@ -66,6 +96,11 @@ const int SEED_DATASET_SIZE = 210;
 const int SEED_DATA_SIZE = 5;
 
 const int STUDENT_DATASET_SIZE = 395;
+const int STUDENT_DATA_SIZE = 10;
+
+// Glyph channel columns of each data set
+GlyphMapping WBC_MAPPING = GlyphMapping::wbc();
+GlyphMapping STUDENT_MAPPING = GlyphMapping::wbc();
 std::vector<std::vector<GLfloat>> passStudents{};
 
 bool STUDENT_HYPER_COLLECTED = false;
@@ -81,20 +116,37 @@ int VIEWPORT_SCALE = 8;					/* viewport scaling constant */
 float THRESHOLD_VALUE = 3.0;			/* threshold calculation value */
 float MIN_THRESHOLD =2.0;
 float ALLOWED_DIFFERENCES = 2;
+std::vector<GLfloat> ATTRIBUTE_THRESHOLDS =	/* per-attribute neighborhood thresholds */
+	{ 2.0, 2.0, 2.0, 3.0, 3.0, 2.0, 2.0, 3.0, 3.0 };
+float OVERLAP_TOLERANCE = 1.0;			/* default cross-class overlap tolerance */
+std::vector<GLfloat> OVERLAP_TOLERANCES{};	/* per-attribute cross-class overlap tolerances */
 float AXIS_LENGTH = 1.0;				/* SPC axis length constant 8 */
 unsigned int DATA_SIZE = 683;			/* cardinality of data set */
 unsigned int DATA_INDEX = 0;			/* current index of data set */
+unsigned int UNIQUE_DATA_SIZE = 0;		/* rows of data set left after deduplication, 0 until counted */
 unsigned int MAX_SIG_INDEX = 9;			/* maximum significant data index */
 const unsigned int HEIGHT_SCALE = 10;	/* height scaling constant */
 const unsigned int WIDTH_SCALE = 4;		/* width scaling constant */
 const float GRID_MARGIN =1.0;			/* glyph grid margin*/
 const float MAR = 10.0;					/* general use margin */
+float GLYPH_FRAME_BUDGET = 50.0;		/* milliseconds per frame for drawing located glyphs */
+unsigned int PC_BINS = 64;			/* bins along each axis of the binned PC view */
+unsigned int TREE_DEPTH = 4;		/* maximum depth of the decision tree hypercubes */
+unsigned int TREE_MIN_LEAF = 5;		/* fewest data points on either side of a decision tree split */
 
 /***************************** DISPLAY FLAGS *******************************************/
 bool DRAW_EDGES = true;				/* toggle drawing edges between glyphs in PC-SPC-SF */
+bool BATCH_GLYPHS = true;			/* toggle batching located glyph lines into one draw call per frame */
+bool GPU_GLYPHS = false;			/* toggle drawing located glyphs with instanced shaders (GLSL 3.30) */
+bool GLYPH_LOD = true;				/* toggle reducing located glyph detail to fit the frame budget */
+bool BUNDLE_EDGES = false;			/* toggle force-directed bundling of edges between located glyphs */
+bool DENSITY_VIEW = false;			/* toggle drawing located glyphs as a per-class density image */
+bool DENSITY_EQUALIZED = false;		/* toggle equalized (on) / log (off) density tone mapping */
+bool PC_DENSITY = false;			/* toggle binned line density / per-row lines in the PC view */
 bool DRAW_AXES = true;				/* toggle glyph SPC axes on / off*/
 bool DISPLAY_ALL = false;			/* toggle entire dataset / single neighborhood views */
 bool DISPLAY_HYPERCUBES = true;		/* toggle displaying hypercubes overlaying PC-SPC-SF */
+bool TREE_HYPERCUBES = true;		/* toggle decision tree leaves (on) / hyperblock model or catalog (off) as hypercubes */
 bool DISPLAY_SELECTOR = true;		/* toggle PC-SPC-SF and glyph grid views */
 bool DYNAMIC_ANGLES = false;		/* toggle computing second SF angle dynamically */
 bool POS_ANGLE = false;				/* toggle (+)/(-) first SF angle */
@@ -104,6 +156,9 @@ bool DOTTED_AXES = false;			/* toggle dotted / solid SPC axes in glyphs */
 bool REPS_OFF = true;				/* toggle grid of representative glyphs */
 bool ANGLE_FOCUS = true;			/* toggle focus on divergent glyph lengths or angles */
 bool BIRD_FOCUS = true;				/* toggle grey / colored SF birds */
+bool IDEAL_GLYPHS = false;			/* toggle ideal class glyphs leading the representative glyphs */
+bool HEADLESS = false;				/* drawing into an offscreen framebuffer, without GLUT */
+const unsigned int RENDER_SEED = 1;	/* seed of the training split of exported views */
 
 /************************* GLYPH GRID CONSTANTS  *******************************/
 int NUM_ROWS = 4;						/* row in glyph grid */
@@ -114,14 +169,18 @@ float GLYPH_TRANSLATE_FACTOR = -0.1;	/* glyph translate factor */
 /********************** REPRESENTATIVE GLYPH CONSTANTS  ***************************/
 std::vector<std::string> labels{};			/* vector of labels of representative glyphs */
 std::vector<std::vector<GLfloat>> reps{};	/* vector of representative glyphs */
-std::vector<bool> repsClass{};				/* vector of classes of representative glyphs */
+std::vector<ClassLabel> repsClass{};		/* vector of classes of representative glyphs */
 std::vector<int> repsSize{};
+std::vector<Hyperblock> repsBlocks{};		/* bounding boxes of representative glyph neighborhoods */
+std::vector<Hyperblock> envelopeBlocks{};	/* saved hyperblock model (or catalog) drawn as envelopes, normalized to [0, 1] */
+std::vector<Hyperblock> treeBlocks{};		/* decision tree leaf regions drawn as envelopes, normalized to [0, 1] */
+const std::string HB_MODEL_FILE = "hyperblockmodel.csv";	/* hyperblock model kept up to date by --hb-append */
 bool REPS_COLLECTED = false;				/* flag if rep glyphs have already been collected */
 bool IDEAL_COLLECTED = false;				/* flag if ideal glyphs h   ave already been collected */
 
 /************** DEBUG DATA STRUCTS (remove later) *******************/
 std::vector<std::vector<GLfloat>> mixedHood{};
-std::vector<bool> mixedClass{};
+std::vector<ClassLabel> mixedClass{};
 std::vector<std::string> mixedLabels{};
 
 // IDEAL BENIGN POINT
@@ -166,75 +225,463 @@ void importHyperblockData(std::vector<std::vector<GLfloat>>* allData)
 	myFile.close();		// close file stream
 }
 
+// Per-frame batches of located glyph geometry, drawn once after every glyph is placed
+VertexBatch glyphLineBatch(GL_LINES);		/* SF stick figure lines */
+VertexBatch axisLineBatch(GL_LINES);		/* SPC cross lines */
+VertexBatch edgeLineBatch(GL_LINES);		/* edges between located glyphs */
+VertexBatch edgeTipBatch(GL_TRIANGLES);		/* arrow tips of edges */
+
+// Geometry of the located glyphs, traced in parallel before drawing and reused between frames
+GlyphGeometry locatedGeometry{};
+
+// Instanced shader renderer of the located glyphs, used when GPU_GLYPHS is set and the context supports it
+GlyphRenderer glyphRenderer{};
+
+// SPC axis frames and grids of the PC-SPC-SF view, recorded once and replayed under the glyphs
+BackgroundLayer spcFrameLayer{};
+
+// Level of detail of the located glyphs, chosen each frame from their size and the time of previous frames
+GlyphLevelOfDetail glyphDetail{};
+
+// Bundled polylines of the edges between located glyphs, kept between frames, used when BUNDLE_EDGES is set
+EdgeBundler locatedEdgeBundler{};
+
+// Per-class density of the located glyphs and its tone-mapped image, used when DENSITY_VIEW is set
+DensityMap locatedDensity{};
+DensityTexture locatedDensityTexture{};
+
+// Parallel coordinates view, its batches and its binned density image
+ParallelCoordinates pcView{};
+VertexBatch pcAxisBatch(GL_LINES);		/* PC axes */
+VertexBatch pcLineBatch(GL_LINES);		/* PC row polylines */
+DensityMap pcDensity{};
+DensityTexture pcDensityTexture{};
+std::size_t pcAxis = 0;					/* position of the PC axis moved by the keyboard */
+
+// Translucent hyperblock envelopes of the PC and SPC views
+VertexBatch envelopeBatch(GL_TRIANGLES);
+
 /* FUNCTION SIGNATURES */
 void drawGridSPC(GLfloat originX, GLfloat originY, GLfloat endX, GLfloat endY, int dimension);
 
 /*
-displayHypercubes
-This function overlays transparent rectangles over
-the SPC-SF visualization. These rectangles are
-representative of hypercubes representing branches
-of the decision tree implemented for WBC data.
+classColor
+Get the color of a class. The first two classes keep the
+original blue (benign) and red (malignant); further classes
+cycle through a fixed palette.
+@param		label	class id
+@return				red, green and blue components of the color
+*/
+const GLfloat* classColor(ClassLabel label)
+{
+	static const GLfloat palette[][3] = {
+		{ 0.0, 0.0, 1.0 },	// blue
+		{ 1.0, 0.0, 0.0 },	// red
+		{ 0.0, 0.6, 0.0 },	// green
+		{ 0.9, 0.5, 0.0 },	// orange
+		{ 0.5, 0.0, 0.7 },	// purple
+		{ 0.0, 0.6, 0.6 },	// teal
+		{ 0.6, 0.4, 0.2 },	// brown
+		{ 0.9, 0.0, 0.6 }	// magenta
+	};
+	return palette[label % (sizeof(palette) / sizeof(palette[0]))];
+}
+
+/*
+setClassColor
+Set the current color to the color of a class.
+@param		label	class id
+			alpha	opacity of the color
+@return				void
+*/
+void setClassColor(ClassLabel label, GLfloat alpha)
+{
+	const GLfloat* color = classColor(label);
+	glColor4f(color[0], color[1], color[2], alpha);
+}
+
+/*
+currentGlyphLayout
+Get the placement of located glyphs for the current window size.
+@param			none
+@return			GlyphLayout		window and scaling constants of the layout
+*/
+GlyphLayout currentGlyphLayout()
+{
+	GlyphLayout layout;
+	layout.screenWidth = SCREEN_WIDTH;
+	layout.screenHeight = SCREEN_HEIGHT;
+	layout.viewportScale = VIEWPORT_SCALE;
+	layout.widthScale = WIDTH_SCALE;
+	layout.heightScale = HEIGHT_SCALE;
+	return layout;
+}
+
+/*
+hypercubeBlocks
+Get the hyperblocks drawn as hypercubes.
+@param			none
+@return			decision tree leaves if TREE_HYPERCUBES is set, the saved hyperblock model or catalog blocks otherwise
+*/
+const std::vector<Hyperblock>& hypercubeBlocks()
+{
+	return TREE_HYPERCUBES ? treeBlocks : envelopeBlocks;
+}
+
+/*
+drawHyperblockEnvelopes
+Draw the envelopes collected in envelopeBatch over the window as
+translucent triangles that do not write depth, so that everything
+drawn after them composites over them, and empty the batch.
 @param			none
 @return			void
 */
-void displayHypercubes()
+void drawHyperblockEnvelopes()
 {
+	glViewport(0.0, 0.0, SCREEN_WIDTH, SCREEN_HEIGHT);
+	glMatrixMode(GL_PROJECTION);
 	glPushMatrix();
-	glEnable(GL_BLEND); //Enable blending.
+	glLoadIdentity();
+	gluOrtho2D(0.0, SCREEN_WIDTH, 0.0, SCREEN_HEIGHT);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	glPushAttrib(GL_ENABLE_BIT | GL_DEPTH_BUFFER_BIT);
+	glEnable(GL_BLEND);
 	glDepthMask(GL_FALSE);
+	envelopeBatch.draw();
+	envelopeBatch.clear();
+	glPopAttrib();
+
+	glPopMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+}
+
+/*
+displayHypercubes
+This function overlays transparent boxes over the
+SPC-SF visualization, one per hypercube in each SPC
+plot, generated from the bounds of the attributes
+placed on the plot's axes.
+@param		numClasses	Number of classes of the blocks
+@return					void
+*/
+void displayHypercubes(std::size_t numClasses)
+{
+	std::vector<GLfloat> palette{};
+	for (ClassLabel label = 0; label < numClasses; ++label)
+	{
+		const GLfloat* color = classColor(label);
+		palette.insert(palette.end(), color, color + 3);
+	}
+
+	batchHyperblockBoxes(hypercubeBlocks(), WBC_MAPPING, currentGlyphLayout(), palette, 0.15, &envelopeBatch);
+	drawHyperblockEnvelopes();
+}
+
+/*
+placeGlyphViewport
+Place the viewport of the next located glyph, either for the GL
+or for the glyph batches.
+@param		x		left edge of the viewport
+			y		bottom edge of the viewport
+@return				void
+*/
+void placeGlyphViewport(GLfloat x, GLfloat y)
+{
+	if (BATCH_GLYPHS)
+	{
+		glyphLineBatch.setViewport(x, y, SCREEN_WIDTH / VIEWPORT_SCALE, SCREEN_WIDTH / VIEWPORT_SCALE);
+		axisLineBatch.setViewport(x, y, SCREEN_WIDTH / VIEWPORT_SCALE, SCREEN_WIDTH / VIEWPORT_SCALE);
+	}
+	else
+	{
+		glViewport(x, y, SCREEN_WIDTH / VIEWPORT_SCALE, SCREEN_WIDTH / VIEWPORT_SCALE);
+	}
+}
+
+/*
+drawGlyphBatches
+Draw the located glyph geometry collected this frame, edges first,
+then SPC crosses and stick figures on top, and empty the batches.
+@param			none
+@return			void
+*/
+void drawGlyphBatches()
+{
+	glViewport(0.0, 0.0, SCREEN_WIDTH, SCREEN_HEIGHT);
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	gluOrtho2D(0.0, SCREEN_WIDTH, 0.0, SCREEN_HEIGHT);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	glLineWidth(0.5);
+	edgeLineBatch.draw();
+	edgeTipBatch.draw();
+
+	if (DOTTED_AXES)
+	{
+		glPushAttrib(GL_ENABLE_BIT);
+		glLineStipple(3, 0xAAAA);
+		glEnable(GL_LINE_STIPPLE);
+	}
+	glLineWidth(2.0);
+	axisLineBatch.draw();
+	if (DOTTED_AXES) glPopAttrib();
+
+	glLineWidth(4.0);
+	glyphLineBatch.draw();
+
+	glPopMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+
+	edgeLineBatch.clear();
+	edgeTipBatch.clear();
+	axisLineBatch.clear();
+	glyphLineBatch.clear();
+}
+
+/*
+drawSpcFrames
+Draw the three SPC axis frames of the PC-SPC-SF view, with the
+grid inside each, in window coordinates.
+@param			none
+@return			void
+*/
+void drawSpcFrames()
+{
+	glColor4f(0.0, 0.0, 0.0, 7.0);
+	int gridMargin = 80;
+	int heightMargin = 10;
+	int numSPC = 3;
+	int dimension = 5;
+	glLineWidth(4.0);
+	// Draw SPC axis frame * 3
+	// Draw 1st SPC axes
+	drawArrow(Point2(0, 0), Point2(0, SCREEN_HEIGHT - 10), SCREEN_HEIGHT);
+	drawArrow(Point2(0, 0), Point2((SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), 0), SCREEN_HEIGHT);
+	// Draw grid inside axes
+	drawGridSPC(0, 0,
+		(SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), SCREEN_HEIGHT - 10, dimension);
+	glLineWidth(3.0);
+	// Draw 2nd SPC axes
+	drawArrow(Point2(((SCREEN_WIDTH) / numSPC), 0),
+		Point2((SCREEN_WIDTH / numSPC), SCREEN_HEIGHT - heightMargin), SCREEN_HEIGHT);
+	drawArrow(Point2((SCREEN_WIDTH / numSPC), 0),
+		Point2(((7 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24), 0), SCREEN_HEIGHT);
+	// Draw grid inside axes
+	drawGridSPC((SCREEN_WIDTH / numSPC) + gridMargin, 0,
+		(SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), SCREEN_HEIGHT - heightMargin, dimension);
+	glLineWidth(3.0);
+	// Draw 3rd SPC axes
+	drawArrow(Point2(((2 * SCREEN_WIDTH) / numSPC), 0),
+		Point2(((2 * SCREEN_WIDTH) / numSPC), SCREEN_HEIGHT - heightMargin), SCREEN_HEIGHT);
+	drawArrow(Point2(((2 * SCREEN_WIDTH) / numSPC), 0),
+		Point2(((11 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24), 0), SCREEN_HEIGHT);
+	// Draw grid inside axes
+	drawGridSPC(((2 * SCREEN_WIDTH) / numSPC) + gridMargin, 0,
+		(SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), SCREEN_HEIGHT - heightMargin, dimension);
+}
+
+/*
+drawSpcFrameLayer
+Draw the SPC axis frames from their cached layer, under the
+located glyphs drawn after it.
+@param			none
+@return			void
+*/
+void drawSpcFrameLayer()
+{
+	glViewport(0.0, 0.0, SCREEN_WIDTH, SCREEN_HEIGHT);
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	gluOrtho2D(0.0, SCREEN_WIDTH, 0.0, SCREEN_HEIGHT);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	spcFrameLayer.draw(SCREEN_WIDTH, SCREEN_HEIGHT, drawSpcFrames);
+
+	glPopMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+}
+
+/*
+currentGlyphDetail
+Level of detail of the located glyphs in the current frame.
+@param			none
+@return			full detail, or the tier picked for the frame if GLYPH_LOD is set
+*/
+GlyphDetail currentGlyphDetail()
+{
+	return GLYPH_LOD ? glyphDetail.getDetail() : GlyphDetail::Full;
+}
+
+/*
+drawDensityPoints
+Draw each traced glyph as a single translucent point in its class
+color, at the center of the copy selected by the flock position.
+Overlapping points build up into a density of each class.
+@param		geometry	Traced geometry of the located glyphs
+			labels		Class of each traced glyph
+@return					void
+*/
+void drawDensityPoints(const GlyphGeometry& geometry, const std::vector<ClassLabel>& labels)
+{
+	if (flockPosition < 1 || flockPosition > 3) return;
+	std::size_t copy = flockPosition - 1;
+	GLfloat center = currentGlyphLayout().viewportSize() / 2;
+
+	glViewport(0.0, 0.0, SCREEN_WIDTH, SCREEN_HEIGHT);
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	gluOrtho2D(0.0, SCREEN_WIDTH, 0.0, SCREEN_HEIGHT);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	glPointSize(3.0);
+	glBegin(GL_POINTS);
+	for (std::size_t i = 0; i < geometry.numRows && i < labels.size(); ++i)
+	{
+		setClassColor(labels[i], 0.3);
+		glVertex2f(geometry.anchorX[copy][i] + center, geometry.anchorY[copy][i] + center);
+	}
+	glEnd();
+	glPointSize(1.0);
+
+	glPopMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+}
+
+/*
+drawDensityView
+Splat the edges and copies of every traced glyph into per-class
+densities at window resolution, tone-map them into one image and
+draw it over the window. Cost follows the distinct pixel edges
+rather than the number of rows, so it replaces the glyphs once
+they overplot into a solid mass.
+@param		geometry	Traced geometry of the located glyphs
+			labels		Class of each traced glyph
+			numClasses	Number of classes
+@return					void
+*/
+void drawDensityView(const GlyphGeometry& geometry, const std::vector<ClassLabel>& labels, std::size_t numClasses)
+{
+	std::vector<GLfloat> palette{};
+	for (ClassLabel label = 0; label < numClasses; ++label)
+	{
+		const GLfloat* color = classColor(label);
+		palette.insert(palette.end(), color, color + 3);
+	}
+
+	locatedDensity.resize(SCREEN_WIDTH, SCREEN_HEIGHT, numClasses);
+	locatedDensity.accumulate(geometry, labels);
+	std::vector<GLubyte> image{};
+	locatedDensity.toneMap(DENSITY_EQUALIZED ? ToneMapping::Equalized : ToneMapping::Log, palette, &image);
+	locatedDensityTexture.upload(locatedDensity.getWidth(), locatedDensity.getHeight(), image);
 
 	glViewport(0.0, 0.0, SCREEN_WIDTH, SCREEN_HEIGHT);
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
 	gluOrtho2D(0.0, SCREEN_WIDTH, 0.0, SCREEN_HEIGHT);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	locatedDensityTexture.draw(SCREEN_WIDTH, SCREEN_HEIGHT);
 
-	// Draw hypercubes based on DT paper
-	// Cube a
-	glColor4f(0.0, 0.0, 0.0, 0.3);
-	glRectf(MAR, MAR, ((SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24)) * 0.25, (SCREEN_HEIGHT - 10));
-
-	// Cube b
-	glColor4f(0.0, 0.0, 1.0, 0.3);
-	glRectf(((SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24)) * 0.25, (SCREEN_HEIGHT - 10) * .45, (SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), SCREEN_HEIGHT - 10);
-
-	// Cube c
-	glColor4f(1.0, 0.0, 0.0, 0.3);
-	glRectf(((SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24)) * 0.25, MAR, (SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), (SCREEN_HEIGHT - 10) * .45);
-
-	// Cube d
-	glColor4f(0.0, 0.0, 1.0, 0.3);
-	glRectf(((SCREEN_WIDTH) / 3) + MAR, MAR,
-		((((SCREEN_WIDTH) / 3) + MAR) + ((((7 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24)) - (((SCREEN_WIDTH) / 3) + MAR)) * .15),
-		SCREEN_HEIGHT - 10);
-
-	// Cube e
-	glColor4f(1.0, 0.0, 0.0, 0.3);
-	glRectf(((((SCREEN_WIDTH) / 3) + MAR) + ((((7 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24)) - (((SCREEN_WIDTH) / 3) + MAR)) * .15),
-		(SCREEN_HEIGHT - 10) * .45, ((7 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24), SCREEN_HEIGHT - 10);
-
-
-	// Cube f
-	glColor4f(0.0, 0.0, 0.0, 0.3);
-	glRectf(((((SCREEN_WIDTH) / 3) + MAR) + ((((7 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24)) - (((SCREEN_WIDTH) / 3) + MAR)) * .15),
-		MAR, ((7 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24), (SCREEN_HEIGHT - 10) * .45);
-
-	// Cube g
-	glColor4f(1.0, 0.0, 0.0, 0.3);
-	glRectf(((2 * SCREEN_WIDTH) / 3) + MAR, SCREEN_HEIGHT * 0.6, ((11 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24), SCREEN_HEIGHT - 10);
-
-	// Cube h
-	glColor4f(0.0, 0.0, 1.0, 0.3);
-	glRectf(((2 * SCREEN_WIDTH) / 3) + MAR, MAR,
-		((((2 * SCREEN_WIDTH) / 3) + MAR) + ((((11 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24)) - (((2 * SCREEN_WIDTH) / 3) + MAR)) * .35),
-		SCREEN_HEIGHT * 0.6);
-
-	// Cube i
-	glColor4f(1.0, 0.0, 0.0, 0.3);
-	glRectf(((((2 * SCREEN_WIDTH) / 3) + MAR) + ((((11 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24)) - (((2 * SCREEN_WIDTH) / 3) + MAR)) * .35),
-		MAR, ((11 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24), (SCREEN_HEIGHT) * 0.6);
-
-	// Disable blending and resume depth mask
-	glDepthMask(GL_TRUE);
-	glDisable(GL_BLEND);
+	glPopMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+}
+
+/*
+batchBundledEdges
+Bundle the edges between the located copies of every traced glyph
+and append the bundled polylines to the edge batches, the second
+edge of each glyph ending in an arrow as when drawn straight.
+Polylines are kept between frames, so only a changed set of
+edges is bundled again.
+@param		geometry	Traced geometry of the located glyphs
+			labels		Class of each traced glyph
+@return					void
+*/
+void batchBundledEdges(const GlyphGeometry& geometry, const std::vector<ClassLabel>& labels)
+{
+	std::size_t numGlyphs = std::min(geometry.numRows, labels.size());
+	std::vector<EdgeBundler::Edge> edges{};
+	for (std::size_t i = 0; i < numGlyphs; ++i)
+	{
+		for (std::size_t k = 0; k < 2; ++k)
+		{
+			edges.push_back({ geometry.edgeX[k][i], geometry.edgeY[k][i], geometry.edgeX[k + 1][i], geometry.edgeY[k + 1][i] });
+		}
+	}
+	locatedEdgeBundler.bundle(edges);
+
+	std::size_t last = locatedEdgeBundler.pointCount() - 1;
+	edgeLineBatch.setWindow();
+	edgeTipBatch.setWindow();
+	for (std::size_t e = 0; e < edges.size(); ++e)
+	{
+		const GLfloat* color = classColor(labels[e / 2]);
+		edgeLineBatch.setColor(color[0], color[1], color[2], 7.0);
+		edgeTipBatch.setColor(color[0], color[1], color[2], 7.0);
+
+		const GLfloat* points = locatedEdgeBundler.polyline(e);
+		std::size_t straight = (e % 2 == 1) ? last - 1 : last;	// the arrow draws the last segment of the second edge
+		for (std::size_t p = 0; p < straight; ++p)
+		{
+			edgeLineBatch.addLine(points[2 * p], points[2 * p + 1], points[2 * p + 2], points[2 * p + 3]);
+		}
+		if (e % 2 == 1)
+		{
+			batchArrow(&edgeLineBatch, &edgeTipBatch, Point2(points[2 * last - 2], points[2 * last - 1]),
+				Point2(points[2 * last], points[2 * last + 1]), (2 * (SCREEN_HEIGHT / 3)));
+		}
+	}
+}
+
+/*
+drawGlyphInstances
+Draw the located glyphs of the traced rows with the instanced
+shader renderer, at the copy selected by the flock position.
+Display toggles are passed as uniforms, so switching them does
+not change the uploaded glyphs.
+@param		data		Rows traced into locatedGeometry
+@return					void
+*/
+void drawGlyphInstances(const DataView& data)
+{
+	// Only one located copy is drawn, and none in the size view of the first or below bird detail
+	GlyphDetail detail = currentGlyphDetail();
+	if (flockPosition < 1 || flockPosition > 3 || (flockPosition == 1 && SIZE_VIEW) || detail > GlyphDetail::Bird) return;
+
+	GlyphStyle style{};
+	style.dynamicAngles = DYNAMIC_ANGLES;
+	style.posAngle = POS_ANGLE;
+	style.angleFocus = ANGLE_FOCUS;
+	style.birdFocus = BIRD_FOCUS;
+	style.drawAxes = DRAW_AXES && detail == GlyphDetail::Full;
+	style.dottedAxes = DOTTED_AXES;
+	style.glyphScaleFactor = (flockPosition == 1) ? GLYPH_SCALE_FACTOR : 0.25;
+	style.axisLength = AXIS_LENGTH;
+
+	glViewport(0.0, 0.0, SCREEN_WIDTH, SCREEN_HEIGHT);
+	glyphRenderer.upload(data, WBC_MAPPING, locatedGeometry, flockPosition - 1);
+	glyphRenderer.draw(currentGlyphLayout(), style);
 }
 
 /*
@@ -243,19 +690,18 @@ This is the driver function for displaying a set of
 three located SPC-SF glyphs in the three paired
 coordinate axes of the visualization (PC-SPC-SF)
 @param		normalData	Data point to be visualized
-			classify	Class of the data point
+			mapping		Columns of the data point read by each glyph channel
+			geometry	Traced geometry of the located glyphs
+			index		Index of the data point in the traced geometry
+			classLabel	Class of the data point
 @return					void
 */
-void drawLocatedGlyphs(std::vector<GLfloat>* normalData, bool classify, int size, int iteration, std::string hbLabel, std::string hbLabel2)
+void drawLocatedGlyphs(RowView normalData, const GlyphMapping& mapping, const GlyphGeometry& geometry, std::size_t index,
+	ClassLabel classLabel, int iteration, std::string hbLabel, std::string hbLabel2)
 {
 	// encode colors to bird glyph winds in located glyphs
 	float colors[6];
-	colors[0] = *(normalData->begin() + 2);
-	colors[1] = *(normalData->begin() + 1);
-	colors[2] = *(normalData->begin() + 0);
-	colors[3] = *(normalData->begin() + 2);
-	colors[4] = *(normalData->begin() + 7);
-	colors[5] = *(normalData->begin() + 6);
+	mapping.colors(normalData, colors);
 	
 	// If color values too high, round down so still visible
 	for (unsigned int i = 0; i < 6; i++)
@@ -268,96 +714,56 @@ void drawLocatedGlyphs(std::vector<GLfloat>* normalData, bool classify, int size
 	
 	glPushMatrix();
 
-	// Encode custom attributes to SPC positions
-	GLfloat ucsize = *(normalData->begin() + 1);
-
-	// Uniformity of cell size
-	GLfloat ucshape = *(normalData->begin() + 2);
-
-	// Clump thickness
-	GLfloat cl = *(normalData->begin());
-
-	// Bland chromatin
-	GLfloat bn = *(normalData->begin() + 5);
-
-	// Marginal adhesion
-	GLfloat bc = *(normalData->begin() + 6);
-
-	std::vector<GLfloat> axesSPC{};
-	axesSPC.push_back(*((normalData)->begin() + 3));	// X1
-	axesSPC.push_back(*((normalData)->begin() + 2));	// Y1
-	axesSPC.push_back(*((normalData)->begin() + 3));	// X2
-	axesSPC.push_back(*((normalData)->begin() + 4));	// Y2
-	axesSPC.push_back(*((normalData)->begin() + 8));	// X3
-	axesSPC.push_back(*((normalData)->begin() + 7));	// Y3
-	// Encode angles with most meaningful attributes
-	std::vector<GLfloat> stickFig{};
-	// Populate: CL (angle), UC (length), BN (angle), BC (length)
-	stickFig.push_back(*((normalData)->begin()));			// Angle 1
-	stickFig.push_back(*((normalData)->begin() + 1));	// Length 1
-	stickFig.push_back(*((normalData)->begin() + 5));	// Angle 2
-	stickFig.push_back(*((normalData)->begin() + 6));	// Length 2
-
-	// Arrange greater SPC position attributes from optimal positioning described in Worland, Wagle, and Kovalerchuk
-	std::vector<GLfloat> position{ cl, bn, ucsize, bc, bn, ucshape };
-	//std::vector<GLfloat> position{ uc, bn, bc, cl, bn, mg };
-	std::vector<GLfloat>::iterator positionIt = position.begin();
-
-	// Glyph 1
-	std::vector<GLfloat>::iterator axes1 = normalData->begin();			// First six attributes used for SPC (6/10)
-	std::vector<GLfloat>::iterator stick1 = normalData->begin() + 6;	// Last four attributes used for SF  (4/10)
-
-	// Glyph 2
-	std::vector<GLfloat>::iterator axes2 = normalData->begin();			// First six attributes used for SPC (6/10)
-	std::vector<GLfloat>::iterator stick2 = normalData->begin() + 6;	// Last four attributes used for SF  (4/10)
-
-	// Glyph 3
-	std::vector<GLfloat>::iterator axes3 = normalData->begin();			// First six attributes used for SPC (6/10)
-	std::vector<GLfloat>::iterator stick3 = normalData->begin() + 6;	// Last four attributes used for SF  (4/10)
+	// Encode SPC axes (X1, Y1, X2, Y2, X3, Y3)
+	GLfloat axesSPC[6];
+	mapping.spcAxes(normalData, axesSPC);
 
 	// *********************** DRAW SF GLYPHS ***********************
-	// Note that we are currently converting 'radians to degrees'
-	// Draw Stick Figure (save vertex positions)
-
-	// Construct glyph tool
-	SpcSfGlyph glyph = SpcSfGlyph();
+	// Stick figures and positions were traced beforehand (see GlyphGeometry),
+	// with positions arranged from optimal positioning described in Worland, Wagle, and Kovalerchuk
+
+	// Reduce detail to the frame's tier: crosses only at full detail, birds down to bird detail.
+	// Stick figures and crosses are drawn later in one instanced call when the GPU renders them
+	GlyphDetail detail = currentGlyphDetail();
+	bool drawGlyphs = detail <= GlyphDetail::Bird && !(GPU_GLYPHS && glyphRenderer.isReady());
+	bool drawCrosses = DRAW_AXES && detail == GlyphDetail::Full;
+	bool drawEdges = DRAW_EDGES && detail <= GlyphDetail::Edge && !BUNDLE_EDGES;	// bundled edges are drawn for all glyphs at once
+
+	// Construct glyph tool, appending to the frame's batches when batching
+	SpcSfGlyph glyph = BATCH_GLYPHS ? SpcSfGlyph(&glyphLineBatch, &axisLineBatch) : SpcSfGlyph();
 	// Construct turtle tool
-	TurtleG* turt = new TurtleG();
+	TurtleG turt = TurtleG();
 
-	Point2* pos2 = new Point2();
-	Point2* pos3 = new Point2();
+	// Ends of the traced SF segments
+	Point2 pos2 = Point2(geometry.pos2X[index], geometry.pos2Y[index]);
+	Point2 pos3 = Point2(geometry.pos3X[index], geometry.pos3Y[index]);
 
 	// Locate the lower-left corner of viewport for glyph drawing
-	GLfloat x1 = ((SCREEN_WIDTH / WIDTH_SCALE) * *positionIt) - ((GLint)SCREEN_WIDTH / (VIEWPORT_SCALE * 2));
-	GLfloat y1 = ((SCREEN_HEIGHT - (SCREEN_HEIGHT / HEIGHT_SCALE)) * *++positionIt) - ((GLint)SCREEN_WIDTH / (VIEWPORT_SCALE * 2));
+	GLfloat x1 = geometry.anchorX[0][index];
+	GLfloat y1 = geometry.anchorY[0][index];
 
 	glPushMatrix();
 
 	if (flockPosition == 1)	// draw flock based on position ID
 	{
 		// Place the viewport
-		glViewport(
-			x1,
-			y1,
-			SCREEN_WIDTH / VIEWPORT_SCALE,
-			SCREEN_WIDTH / VIEWPORT_SCALE
-		);
+		placeGlyphViewport(x1, y1);
 
 		
 		//Glyph1
 		glLineWidth(4.0);
 
 		// Switch between glyphs and bars representing size of cluster
-		if (!SIZE_VIEW)
+		if (!SIZE_VIEW && drawGlyphs)
 		{
-			glyph.drawGlyphSF(pos2, pos3, stickFig.begin(), classify, *turt, DYNAMIC_ANGLES, POS_ANGLE, GLYPH_SCALE_FACTOR, 0.1, 2.0, ANGLE_FOCUS, BIRD_FOCUS, colors);
+			glyph.drawTracedGlyphSF(pos2, pos3, turt, BIRD_FOCUS, colors);
 			// RESET THE CP AND CD
-			turt->setCP(0.0, 0.0);
+			turt.setCP(0.0, 0.0);
 			// *********************** DRAW SPC AXES ***********************
-			if (DRAW_AXES)
+			if (drawCrosses)
 			{
 				glLineWidth(2.0);
-				glyph.drawAxesSPC(*pos2, *pos3, axesSPC.begin(), AXIS_LENGTH, GLYPH_SCALE_FACTOR, DOTTED_AXES);
+				glyph.drawAxesSPC(pos2, pos3, axesSPC, AXIS_LENGTH, GLYPH_SCALE_FACTOR, DOTTED_AXES);
 			}
 		}
 
@@ -383,8 +789,8 @@ void drawLocatedGlyphs(std::vector<GLfloat>* normalData, bool classify, int size
 	}
 	
 	// Locate the viewport for glyph drawing
-	GLfloat x2 = ((SCREEN_WIDTH / WIDTH_SCALE) * *++positionIt) + (SCREEN_WIDTH / 3) - ((GLint)SCREEN_WIDTH / (VIEWPORT_SCALE * 2));
-	GLfloat y2 = ((SCREEN_HEIGHT - (SCREEN_HEIGHT / HEIGHT_SCALE)) * *++positionIt) - ((GLint)SCREEN_WIDTH / (VIEWPORT_SCALE * 2));
+	GLfloat x2 = geometry.anchorX[1][index];
+	GLfloat y2 = geometry.anchorY[1][index];
 
 	// maintain record of minimum and maximum Y values in hyperblock,
 	// for placement of average glyph
@@ -404,24 +810,22 @@ void drawLocatedGlyphs(std::vector<GLfloat>* normalData, bool classify, int size
 	{
 
 		// Locate the viewport for glyph drawing
-		glViewport(
-			x2,
-			y2,
-			SCREEN_WIDTH / VIEWPORT_SCALE,
-			SCREEN_WIDTH / VIEWPORT_SCALE
-		);
+		placeGlyphViewport(x2, y2);
 		
 		//Glyph2
-		glLineWidth(4.0);
-		glyph.drawGlyphSF(pos2, pos3, stickFig.begin(), classify, *turt, DYNAMIC_ANGLES, POS_ANGLE, 0.25, 0.1, 2.0, ANGLE_FOCUS, BIRD_FOCUS, colors);
-		// RESET THE CP AND CD
-		turt->setCP(0.0, 0.0);
-
-		// *********************** DRAW SPC AXES ***********************
-		if (DRAW_AXES)
+		if (drawGlyphs)
 		{
-			glLineWidth(2.0);
-			glyph.drawAxesSPC(*pos2, *pos3, axesSPC.begin(), AXIS_LENGTH, 0.25, DOTTED_AXES);
+			glLineWidth(4.0);
+			glyph.drawTracedGlyphSF(pos2, pos3, turt, BIRD_FOCUS, colors);
+			// RESET THE CP AND CD
+			turt.setCP(0.0, 0.0);
+
+			// *********************** DRAW SPC AXES ***********************
+			if (drawCrosses)
+			{
+				glLineWidth(2.0);
+				glyph.drawAxesSPC(pos2, pos3, axesSPC, AXIS_LENGTH, 0.25, DOTTED_AXES);
+			}
 		}
 
 
@@ -443,30 +847,28 @@ void drawLocatedGlyphs(std::vector<GLfloat>* normalData, bool classify, int size
 
 
 	// Locate the viewport for glyph drawing
-	GLfloat x3 = ((SCREEN_WIDTH / WIDTH_SCALE) * *++positionIt) + (((2 * SCREEN_WIDTH) / 3)) - ((GLint)SCREEN_WIDTH / (VIEWPORT_SCALE * 2));
-	GLfloat y3 = ((SCREEN_HEIGHT - (SCREEN_HEIGHT / HEIGHT_SCALE)) * *++positionIt) - ((GLint)SCREEN_WIDTH / (VIEWPORT_SCALE * 2));
+	GLfloat x3 = geometry.anchorX[2][index];
+	GLfloat y3 = geometry.anchorY[2][index];
 
 	if (flockPosition == 3)
 	{
 		// Locate the viewport for glyph drawing
-		glViewport(
-			x3,
-			y3,
-			SCREEN_WIDTH / VIEWPORT_SCALE,
-			SCREEN_WIDTH / VIEWPORT_SCALE
-		);
+		placeGlyphViewport(x3, y3);
 		
 
 		//Glyph3
-		glLineWidth(4.0);
-		glyph.drawGlyphSF(pos2, pos3, stickFig.begin(), classify, *turt, DYNAMIC_ANGLES, POS_ANGLE, 0.25, 0.1, 2.0, ANGLE_FOCUS, BIRD_FOCUS, colors);
-		// RESET THE CP AND CD
-		turt->setCP(0.0, 0.0);
-		// *********************** DRAW SPC AXES ***********************
-		if (DRAW_AXES)
+		if (drawGlyphs)
 		{
-			glLineWidth(2.0);
-			glyph.drawAxesSPC(*pos2, *pos3, axesSPC.begin(), AXIS_LENGTH, 0.25, DOTTED_AXES);
+			glLineWidth(4.0);
+			glyph.drawTracedGlyphSF(pos2, pos3, turt, BIRD_FOCUS, colors);
+			// RESET THE CP AND CD
+			turt.setCP(0.0, 0.0);
+			// *********************** DRAW SPC AXES ***********************
+			if (drawCrosses)
+			{
+				glLineWidth(2.0);
+				glyph.drawAxesSPC(pos2, pos3, axesSPC, AXIS_LENGTH, 0.25, DOTTED_AXES);
+			}
 		}
 		/*
 		if (classify)	// blue for benign
@@ -640,46 +1042,24 @@ void drawLocatedGlyphs(std::vector<GLfloat>* normalData, bool classify, int size
 	glMatrixMode(GL_PROJECTION);
 	glViewport(0.0, 0.0, SCREEN_WIDTH, SCREEN_HEIGHT);
 	gluOrtho2D(0.0, SCREEN_WIDTH, 0.0, SCREEN_HEIGHT);
-	glColor4f(0.0, 0.0, 0.0, 7.0);
-	int gridMargin = 80;
-	int heightMargin = 10;
-	int numSPC = 3;
-	int dimension = 5;
 	glPushMatrix();
-	glLineWidth(4.0);
-	// Draw SPC axis frame * 3
-	// Draw 1st SPC axes
-	drawArrow(Point2(0, 0), Point2(0, SCREEN_HEIGHT - 10), SCREEN_HEIGHT);
-	drawArrow(Point2(0, 0), Point2((SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), 0), SCREEN_HEIGHT);
-	// Draw grid inside axes
-	drawGridSPC(0, 0,
-		(SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), SCREEN_HEIGHT - 10, dimension);
-	glLineWidth(3.0);
-	// Draw 2nd SPC axes
-	drawArrow(Point2(((SCREEN_WIDTH) / numSPC), 0),
-		Point2((SCREEN_WIDTH / numSPC), SCREEN_HEIGHT - heightMargin), SCREEN_HEIGHT);
-	drawArrow(Point2((SCREEN_WIDTH / numSPC), 0),
-		Point2(((7 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24), 0), SCREEN_HEIGHT);
-	// Draw grid inside axes
-	drawGridSPC((SCREEN_WIDTH / numSPC) + gridMargin, 0,
-		(SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), SCREEN_HEIGHT - heightMargin, dimension);
-	glLineWidth(3.0);
-	// Draw 3rd SPC axes
-	drawArrow(Point2(((2 * SCREEN_WIDTH) / numSPC), 0),
-		Point2(((2 * SCREEN_WIDTH) / numSPC), SCREEN_HEIGHT - heightMargin), SCREEN_HEIGHT);
-	drawArrow(Point2(((2 * SCREEN_WIDTH) / numSPC), 0),
-		Point2(((11 * SCREEN_WIDTH) / 12) + (SCREEN_WIDTH / 24), 0), SCREEN_HEIGHT);
-	// Draw grid inside axes
-	drawGridSPC(((2 * SCREEN_WIDTH) / numSPC) + gridMargin, 0,
-		(SCREEN_WIDTH / 4) + (SCREEN_WIDTH / 24), SCREEN_HEIGHT - heightMargin, dimension);
 
 	// DON't POP MATRIX HERE
 	
+	// Append edges between glyphs to the frame's batches
+	if (drawEdges && BATCH_GLYPHS)
+	{
+		const GLfloat* color = classColor(classLabel);
+		edgeLineBatch.setColor(color[0], color[1], color[2], 7.0);
+		edgeTipBatch.setColor(color[0], color[1], color[2], 7.0);
+		edgeLineBatch.addLine(geometry.edgeX[0][index], geometry.edgeY[0][index], geometry.edgeX[1][index], geometry.edgeY[1][index]);
+		batchArrow(&edgeLineBatch, &edgeTipBatch, Point2(geometry.edgeX[1][index], geometry.edgeY[1][index]),
+			Point2(geometry.edgeX[2][index], geometry.edgeY[2][index]), (2 * (SCREEN_HEIGHT / 3)));
+	}
 	// Draw edges between glyphs
-	if (DRAW_EDGES)
+	else if (drawEdges)
 	{	// Determine which class/color the edge belongs to
-		if (classify)	glColor4f(0.0, 0.0, 1.0, 7.0);
-		else			glColor4f(1.0, 0.0, 0.0, 7.0);
+		setClassColor(classLabel, 7.0);
 		glLineWidth(0.5);
 		glPushMatrix();	// Push new modelview matrix for translation
 		glTranslatef(-((GLint)SCREEN_WIDTH / (VIEWPORT_SCALE * 2)), -((GLint)SCREEN_WIDTH / (VIEWPORT_SCALE * 2)), 0);
@@ -761,66 +1141,32 @@ float euclideanDistance(std::vector<float>* vec1, std::vector<float>* vec2)
 }
 
 /*
-isClose
-This function is a helper function for the isClose function.
-It is used to determine whether two given data points are within
-the given threshold of each other, and thus are in the same
-neighborhood.
-@param		vec1		the first data point to be compared
-			vec2		the second data point to be compared
-@return					boolean value, is vec2 within threshold
-						of vec1
+attributeThresholds
+Per-attribute neighborhood thresholds of the clustering kernels: the
+configured ATTRIBUTE_THRESHOLDS, padded with THRESHOLD_VALUE
+for attributes past the end of the list.
+@param		dimension	number of attributes in the data set
+@return					threshold of each attribute
 */
-bool isClose(std::vector<float>* vec1, std::vector<float>* vec2)
+std::vector<GLfloat> attributeThresholds(std::size_t dimension)
 {
-	// modified HyClu hypercube clustering algorithm. algorithm now forms Hyperblocks.
-	// Threshold value for attributes used in SPC shifts is MIN_THRESHOLD
-	// Threshold value for attributes allowed to expand is THRESHOLD
-	
-	// Initialize iterators for vectors to be compared
-	std::vector<float>::iterator it1 = vec1->begin();
-	std::vector<float>::iterator it2 = vec2->begin();
-
-	int count = 0;
-	for (it1; it1 != vec1->end(); ++it1)
-	{
-		if (count == 0 || count == 1 || count == 2 || count == 5 || count == 6)
-		{
-			if (abs(*it1 - *it2) > MIN_THRESHOLD)
-			{
-				return false;
-			}
-		}
-		else if (count == 3 || count == 4 || count == 7 || count == 8)
-		{
-			if (abs(*it1 - *it2) > THRESHOLD_VALUE)
-			{
-				return false;
-			}
-		}
-
-		++count;
-		++it2;
-	}
-	// Return true if all attributes are within threshold
-	return true;
+	std::vector<GLfloat> thresholds(ATTRIBUTE_THRESHOLDS);
+	thresholds.resize(dimension, THRESHOLD_VALUE);
+	return thresholds;
+}
 
-	
-	/*
-	std::vector<float>::iterator it1 = vec1->begin();
-	std::vector<float>::iterator it2 = vec2->begin();
-	int count = 0;
-	for (it1; it1 != vec1->end(); ++it1)
-	{
-		if (abs(*it1 - *it2) > THRESHOLD_VALUE)
-		{
-			return false;
-		}
-		++it2;
-	}
-	// Return true if all attribtes are within threshold
-	return true;
-	*/
+/*
+overlapTolerances
+Tolerance of each attribute for cross-class overlap, from the
+configured OVERLAP_TOLERANCES, padded with OVERLAP_TOLERANCE
+@param		dimension	number of attributes
+@return					vector of tolerances
+*/
+std::vector<GLfloat> overlapTolerances(std::size_t dimension)
+{
+	std::vector<GLfloat> tolerances(OVERLAP_TOLERANCES);
+	tolerances.resize(dimension, OVERLAP_TOLERANCE);
+	return tolerances;
 }
 
 /*
@@ -838,11 +1184,15 @@ std::vector<bool> computeAllDistances(std::vector<GLfloat>* curr, std::vector<st
 	//std::vector<float> data0();
 	std::vector<bool> close{};
 
+	// Compile the neighborhood bounds of the current point once
+	ThresholdPredicate predicate(ATTRIBUTE_THRESHOLDS, THRESHOLD_VALUE);
+	predicate.compile(*curr);
+
 	// Populate boolean vector to determine
 	// which data points are within threshold of current point
 	for (std::vector<std::vector<GLfloat>>::iterator iter = data->begin(); iter != data->end(); ++iter)
 	{
-		close.push_back(isClose(curr, &(*iter)));
+		close.push_back(predicate(*iter));
 	}
 
 	// Close file streams
@@ -887,6 +1237,115 @@ void loadConfig()
 	std::istringstream sin3(line.substr(line.find("=") + 1));
 	sin3 >> SCREEN_HEIGHT;
 
+	// Read optional keyed parameters from the remaining lines
+	while (getline(myFile, line))
+	{
+		std::string key = line.substr(0, line.find("="));
+		key.erase(std::remove(key.begin(), key.end(), ' '), key.end());
+
+		if (key == "ATTRIBUTE_THRESHOLDS")
+		{	// Comma-separated threshold of each attribute
+			ATTRIBUTE_THRESHOLDS.clear();
+			std::stringstream ss(line.substr(line.find("=") + 1));
+			std::string substr = "";
+			while (getline(ss, substr, ','))
+			{
+				ATTRIBUTE_THRESHOLDS.push_back(stof(substr));
+			}
+		}
+		else if (key.find("_GLYPH_") != std::string::npos)
+		{	// Glyph channel columns of a data set, e.g. WBC_GLYPH_SPC = 3, 2, 3, 4, 8, 7
+			std::string dataset = key.substr(0, key.find("_GLYPH_"));
+			std::string channel = key.substr(key.find("_GLYPH_") + 7);
+			GlyphMapping* mapping = nullptr;
+			std::size_t dimension = 0;
+			if (dataset == "WBC")			{ mapping = &WBC_MAPPING; dimension = MAX_SIG_INDEX; }
+			else if (dataset == "STUDENT")	{ mapping = &STUDENT_MAPPING; dimension = STUDENT_DATA_SIZE; }
+
+			// Keep the default columns of an invalid channel group
+			if (mapping == nullptr || !mapping->parse(channel, line.substr(line.find("=") + 1), dimension))
+			{
+				std::cout << "Error: Invalid glyph mapping " << key << ", using the default columns\n";
+			}
+		}
+		else if (key == "GLYPH_LOD")
+		{	// 1 to reduce located glyph detail to fit the frame budget
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> GLYPH_LOD;
+		}
+		else if (key == "GLYPH_FRAME_BUDGET")
+		{	// Milliseconds per frame for drawing located glyphs
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> GLYPH_FRAME_BUDGET;
+			glyphDetail.setBudget(GLYPH_FRAME_BUDGET);
+		}
+		else if (key == "IDEAL_GLYPHS")
+		{	// 1 to lead the representative glyphs with the mean glyph of each class
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> IDEAL_GLYPHS;
+		}
+		else if (key == "DISPLAY_ALL")
+		{	// 1 to show every row in the SPC-SF and PC views instead of one neighborhood
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> DISPLAY_ALL;
+		}
+		else if (key == "DENSITY_VIEW")
+		{	// 1 to draw located glyphs as a per-class density image
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> DENSITY_VIEW;
+		}
+		else if (key == "DENSITY_EQUALIZED")
+		{	// 1 for equalized density tone mapping, 0 for log
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> DENSITY_EQUALIZED;
+		}
+		else if (key == "TREE_HYPERCUBES")
+		{	// 1 to draw decision tree leaves as hypercubes, 0 for the hyperblock catalog
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> TREE_HYPERCUBES;
+		}
+		else if (key == "TREE_DEPTH")
+		{	// Maximum depth of the decision tree hypercubes
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> TREE_DEPTH;
+		}
+		else if (key == "TREE_MIN_LEAF")
+		{	// Fewest data points on either side of a decision tree split
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> TREE_MIN_LEAF;
+		}
+		else if (key == "PC_DENSITY")
+		{	// 1 to draw the PC view as binned line density
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> PC_DENSITY;
+		}
+		else if (key == "PC_BINS")
+		{	// Bins along each axis of the binned PC view
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> PC_BINS;
+		}
+		else if (key == "BUNDLE_EDGES")
+		{	// 1 to bundle the edges between located glyphs
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> BUNDLE_EDGES;
+		}
+		else if (key == "GPU_GLYPHS")
+		{	// 1 to draw located glyphs with instanced shaders
+			std::istringstream sin(line.substr(line.find("=") + 1));
+			sin >> GPU_GLYPHS;
+		}
+		else if (key == "OVERLAP_TOLERANCES")
+		{	// Comma-separated cross-class overlap tolerance of each attribute
+			OVERLAP_TOLERANCES.clear();
+			std::stringstream ss(line.substr(line.find("=") + 1));
+			std::string substr = "";
+			while (getline(ss, substr, ','))
+			{
+				OVERLAP_TOLERANCES.push_back(stof(substr));
+			}
+		}
+	}
+
 	/*
 	getline(myFile, line);
 	// GLYPH_SIZE
@@ -905,6 +1364,22 @@ void loadConfig()
 	*/
 }
 
+/*
+myReshape
+This is the OpenGL reshape callback function. Takes on the new
+window size and re-records the cached background for it.
+@param		width	new window width
+			height	new window height
+@return				void
+*/
+void myReshape(int width, int height)
+{
+	SCREEN_WIDTH = width;
+	SCREEN_HEIGHT = height;
+	spcFrameLayer.invalidate();
+	glViewport(0, 0, width, height);
+}
+
 /*
 myIdle
 This is the OpenGL idle callback function.
@@ -932,7 +1407,7 @@ void mouse_button_callback(int button, int state, int x, int y)
 		glutPostRedisplay();
 	}
 	// Right mouse button increments the current data index
-	else if (DATA_INDEX < DATA_SIZE && state == GLUT_DOWN && button == GLUT_RIGHT_BUTTON)
+	else if (DATA_INDEX + 1 < UNIQUE_DATA_SIZE && state == GLUT_DOWN && button == GLUT_RIGHT_BUTTON)
 	{
 		DATA_INDEX += 1;
 		glutPostRedisplay();
@@ -960,7 +1435,7 @@ void keyboard_special(int key, int x, int y)
 		DATA_INDEX -= 1;
 	}
 	// Right arrow key increments the current data index
-	else if (DATA_INDEX < DATA_SIZE && key == GLUT_KEY_RIGHT)
+	else if (DATA_INDEX + 1 < UNIQUE_DATA_SIZE && key == GLUT_KEY_RIGHT)
 	{
 		glClearColor(1.0, 1.0, 1.0, 1.0);
 		glClear(GL_COLOR_BUFFER_BIT);
@@ -1086,6 +1561,51 @@ void myKeyboard(unsigned char key, int x, int y)
 		++flockPosition;
 	}
 
+	if (key == 'd') {
+		// toggle the density view of the located glyphs
+		DENSITY_VIEW = !DENSITY_VIEW;
+	}
+
+	if (key == 'e') {
+		// toggle equalized / log density tone mapping
+		DENSITY_EQUALIZED = !DENSITY_EQUALIZED;
+	}
+
+	if (key == 'b') {
+		// toggle bundling of the edges between located glyphs
+		BUNDLE_EDGES = !BUNDLE_EDGES;
+	}
+
+	if (key == 't') {
+		// toggle decision tree / catalog hypercubes
+		TREE_HYPERCUBES = !TREE_HYPERCUBES;
+	}
+
+	if (key == 'l') {
+		// toggle binned line density in the PC view
+		PC_DENSITY = !PC_DENSITY;
+	}
+
+	if (key == '[' && pcAxis > 0) {
+		// select the PC axis to the left
+		--pcAxis;
+	}
+
+	if (key == ']' && pcAxis + 1 < pcView.getNumDimensions()) {
+		// select the PC axis to the right
+		++pcAxis;
+	}
+
+	if (key == ',') {
+		// move the selected PC axis left
+		pcAxis = pcView.moveAxis(pcAxis, -1);
+	}
+
+	if (key == '.') {
+		// move the selected PC axis right
+		pcAxis = pcView.moveAxis(pcAxis, 1);
+	}
+
 	// Redisplay with updated parameters
 	glutPostRedisplay();
 }
@@ -1170,320 +1690,203 @@ getIdealGLyphs
 This function computes an ideal glyph for each class,
 using the class average for each attribute,
 and adds the glyphs to the rep glyph vector.
-@param		allData		copy of data set
-@return		classify	data set class labels
+@param		data		view of data set
+			classify	data set class labels, by row id
+			counts		data set class counts, by row id
 */
-void getIdealGlyphs(std::vector<std::vector<GLfloat>>* all_Data,
-	std::vector<bool>* classify)
+void getIdealGlyphs(const DataView& data, const LabelColumn& classify, const RowCounts& counts)
 {
-	// Make deep copy of all data
-	std::vector<std::vector<GLfloat>> allData(*all_Data);
-	std::vector<bool> classifyCopy(*classify);
-
-	// Set iterators to copies
-	std::vector<std::vector<GLfloat>>::iterator dataIt = allData.begin();
-	std::vector<bool>::iterator classIt = classifyCopy.begin();
-
-	// Initialize temp class vectors
-	std::vector<std::vector<GLfloat>> malSet{};
-	std::vector<std::vector<GLfloat>> benSet{};
-
-	// Iterate through all data
-	for (dataIt; dataIt != allData.end(); ++dataIt)
+	// List each selected row once per class it holds, weighted by its count of that class
+	std::vector<unsigned int> classIds{};
+	std::vector<ClassLabel> rowLabels{};
+	std::vector<unsigned int> rowWeights{};
+	for (std::size_t i = 0; i < data.size(); ++i)
 	{
-		if (*classIt)
-		{	// add point to class 1
-			benSet.push_back(*dataIt);
-		}
-		else
-		{	// add point to class 2
-			malSet.push_back(*dataIt);
+		for (ClassLabel label = 0; label < classify.numClasses(); ++label)
+		{
+			unsigned int count = counts.count(data.id(i), label);
+			if (count == 0) continue;
+			classIds.push_back(data.id(i));
+			rowLabels.push_back(label);
+			rowWeights.push_back(count);
 		}
-		// increment class iterator
-		++classIt;
 	}
 
-	// Initialize temporary benign vec
-	std::vector<GLfloat> tempBen{};
+	// Gather per-class statistics in a single pass over the columns
+	ClassStatistics stats;
+	stats.compute(DataView(data.getRows(), classIds), MAX_SIG_INDEX,
+		rowLabels, rowWeights, (unsigned int)classify.numClasses());
 
-	// Compute average points for benign class
-	for (unsigned int index = 0; index < MAX_SIG_INDEX; ++index)
-	{	// For the current index of each vector
-		GLfloat tempAttr = 0.0;
-		for (auto& vec : benSet)
-		{	// For each vector
-			tempAttr += vec[index];
-		}
-		// Compute average value from sum
-		tempAttr /= benSet.size();
-		// Add to representative point
-		tempBen.push_back(tempAttr);
-	}
+	for (ClassLabel label = 0; label < classify.numClasses(); ++label)
+	{
+		if (stats.count(label) == 0) continue;	// no rows of this class selected
 
-	// Initialize temporary malig vec
-	std::vector<GLfloat> tempMal{};
-	// Compute average points for malignant class
-	for (unsigned int index = 0; index < MAX_SIG_INDEX; ++index)
-	{	// For the current index of each vector
-		GLfloat tempAttr = 0.0;
-		for (auto& vec : malSet)
-		{	// For each vector
-			tempAttr += vec[index];
-		}
-		// Compute average value from sum
-		tempAttr /= malSet.size();
-		// Add to representative point
-		tempMal.push_back(tempAttr);
+		// Ideal glyphs are the class means of each attribute
+		reps.push_back(stats.meanPoint(label));
+		labels.push_back("ideal " + classify.name(label));
+		repsClass.push_back(label);
 	}
 
-	// Push ideal glyphs to rep vector
-	reps.push_back(tempBen);
-	reps.push_back(tempMal);
-
-	// Push ideal glyph labels to label vector
-	labels.push_back("ideal B");
-	labels.push_back("ideal M");
-
-	// Push ideal glyph class to class vector
-	repsClass.push_back(true);
-	repsClass.push_back(false);
-
 	// Set condition for ideal glyphs collected
 	IDEAL_COLLECTED = true;
 }
 
 /*
 analyzeGlyphShape
-This function analyzes all data points in the set to form a subset of
-points from both classes which are most similar to each other
-(and thus at risk for misclassification)
-@param		all_data	pointer to data set
-			classify	pointer to vector of class labels
+This function finds the points of every class that overlap a point
+of another class within the configured per-attribute tolerance
+(and thus are at risk for misclassification), and saves them for
+analysis, most at risk first.
+@param		data		view of data set
+			counts		class counts of each row, by row id
 */
-void analyzeGlyphShape(std::vector<std::vector<GLfloat>>* all_Data,
-	std::vector<bool>* classify)
+void analyzeGlyphShape(const DataView& data, const RowCounts& counts)
 {
-	// Make deep copy of all data
-	std::vector<std::vector<GLfloat>> allData(*all_Data);
-	std::vector<bool> classVec(*classify);
-	// Initialize iterator from the class vector
-	std::vector<bool>::iterator classIt = classVec.begin();
-
-	// Initialize temp variables to track wing size
-	float leftWingMax = 0.0;
-	float rightWingMax = 0.0;
-	// Initalize temp vector to hold current max point
-	std::vector<GLfloat> currMaxWingPoint;
-
-	// Search for the point from class one with largest attributes for wing length
-	for (std::vector<std::vector<GLfloat>>::iterator dataIt = allData.begin();
-		dataIt != allData.end(); ++dataIt)
-	{
-		if (*classIt)	// if point belongs to the benign class
-		{
-			// analyze for max wing lengths
-			std::vector<float>::iterator currIt = dataIt->begin();
-			if ((*(currIt + 1) > leftWingMax) && (*(currIt + 6) > rightWingMax))
-			{
-				// save current max point to mariable
-				currMaxWingPoint = *dataIt;
-
-				// update max length variables
-				leftWingMax = *(currIt + 1);
-				rightWingMax = *(currIt + 6);
-			}
-		}
-		++classIt;
-	}
+	analyzeGlyphs.clear();
+	analyzeClass.clear();
+	analyzeRisk.clear();
+	if (data.size() == 0) return;
 
-	// save selected point from class one for analysis
-	analyzeGlyphs.push_back(currMaxWingPoint);
+	// Find every overlapping pair of points of different classes
+	OverlapRegions overlap(overlapTolerances(data[0].size()));
+	analyzePairs = overlap.compute(data, counts);
+	const std::vector<GLfloat>& risk = overlap.getRisk();
 
-	classIt = classVec.begin();	// reset class iterator
-		
-	// Search for the most similar points from class 2, to the selected pointd
-	// Search for the point from class one with largest attributes for wing length
-	for (std::vector<std::vector<GLfloat>>::iterator dataIt = allData.begin();
-		dataIt != allData.end(); ++dataIt)
+	// Order the points at risk from most to least
+	std::vector<unsigned int> atRisk{};
+	for (unsigned int i = 0; i < risk.size(); ++i)
 	{
-		if (!*classIt)	// if point belongs to the benign class
-		{
-			// initialize iterator to current point
-			std::vector<float>::iterator currIt = dataIt->begin();
-			// if current point is close to the selected point from class one
-			if ((*(currIt + 1) <= leftWingMax) && (*(currIt + 6) <= rightWingMax))
-			{
-				// save point for analysis
-				analyzeGlyphs.push_back(*dataIt);
-			}
+		if (risk[i] > 0.0) atRisk.push_back(i);
+	}
+	std::stable_sort(atRisk.begin(), atRisk.end(),
+		[&](unsigned int lhs, unsigned int rhs) { return risk[lhs] > risk[rhs]; });
 
-		}
-		++classIt;	// Increment iterators
+	// save points at risk for analysis
+	for (unsigned int i : atRisk)
+	{
+		RowView point = data[i];
+		analyzeGlyphs.push_back(std::vector<GLfloat>(point.begin(), point.end()));
+		analyzeClass.push_back(counts.dominant(data.id(i)));
+		analyzeRisk.push_back(risk[i]);
 	}
+
+	// Set condition for analyzed glyphs collected
+	ANALYZE_COLLECTED = true;
 }
 
 // Retrieve vector of representative glyphs for each neighborhood
-void getRepresentativeGlyphs(std::vector<std::vector<GLfloat>>* all_Data,
-	std::vector<bool>* classify)
+// (each row is weighted by its class counts)
+void getRepresentativeGlyphs(const DataView& data, const RowCounts& counts)
 {
-	unsigned int dataIndex = 0;
-
-	// Make deep copy of all data
-	std::vector<std::vector<GLfloat>> allData(*all_Data);
-	std::vector<bool> classifyCopy(*classify);
 	std::vector<bool> thresholds{};
 
+	// Build dimension-specialized kernels once over the underlying rows
+	std::unique_ptr<RowKernels> kernels = makeRowKernels(data.getRows(), attributeThresholds(MAX_SIG_INDEX));
+
+	// Ids of the points not yet assigned to a neighborhood
+	std::vector<unsigned int> remaining(data.getIds());
+	std::vector<unsigned int> unclustered{};
+
 	bool addThis = false;
 
-	int benCount = 0;
-	int malCount = 0;
+	ClassHistogram hoodClasses(counts.getNumClasses());	// class counts of current neighborhood
 	int hoodCount = 0;
 	// Loop through data, adding one point from each neighborhood to the REPS array
 	// Until all points have been processed
-	while (allData.size() != 0)
+	while (remaining.size() != 0)
 	{
-		// Compute points within threshold
-		thresholds = computeAllDistances(&allData[dataIndex], &allData);
+		// Compute points within threshold of the first remaining point
+		kernels->closeTo(remaining.front(), remaining, &thresholds);
 
-		// Initialize temporary vector for calculating average glyph
-		std::vector< std::vector<GLfloat>> tempData{};
-
-		// Initialize vector iterators
-		std::vector<std::vector<GLfloat>>::iterator dataIt = allData.begin();
-		std::vector<bool>::iterator classIt = classifyCopy.begin();
-		std::vector<bool>::iterator threshIt = thresholds.begin();
+		// Ids of the points in the current neighborhood
+		std::vector<unsigned int> tempIds{};
+		unclustered.clear();
 
 		// Save first point in cluster for comparison
-		std::vector<float> currPoint = (*dataIt);
-		//std::vector<float>::iterator it1End = (*dataIt).end();
-		/*
-		if (hoodCount == 1)
-		{	// Add rep glyph to mixed view
-			mixedHood.push_back(*dataIt);
-			mixedClass.push_back(false);
-		}
-		*/
-		addThis = true;
-		// Use threshold values to remove points
-		while (dataIt != allData.end())
+		RowView currPoint = data.row(remaining.front());
+
+		// Use threshold values to split off the neighborhood
+		for (std::size_t i = 0; i < remaining.size(); ++i)
 		{
+			unsigned int rowId = remaining[i];
+			if (!thresholds[i])
+			{	// Keep point for a later neighborhood
+				unclustered.push_back(rowId);
+				continue;
+			}
+
 			addThis = true;
-			// If current point is in current neighborhood
-			if (*threshIt)
+			// Add class to class count
+			counts.addTo(rowId, &hoodClasses);
+
+			// If currently analyzing chosen focus cluster,
+			// save the point and its class for analysis
+			if (hoodCount == CLUSTER)
 			{
-				// Add class to class count
-				if (*classIt)
-				{
-					++benCount;
-				}
-				else if (!*classIt)
-				{
-					++malCount;
-				}
+				RowView point = data.row(rowId);
 
-				// If currently analyzing chosen focus cluster,
-				// and current point is off the same class as the center of the cluster.
-				if (hoodCount == CLUSTER && (*classIt || !*classIt))
-				{	// Save the point and its class for analysis
-					// extract outlying benign points hood[0]
-					std::vector<float>::iterator it2 = (*dataIt).begin();
-
-					int difCount = 0;	// track number of divergent attributes in current point
-					// Check each pair of elements from each vector for difference within threshold value
-					for (std::vector<float>::iterator it1 = currPoint.begin(); it1 != currPoint.end(); ++it1)
-					{	
-						// If the absolute value of the difference of the pair of attributes
-						// is below the allowed minimum threshold value
-						if (abs(*it1 - *it2) >= MIN_THRESHOLD)
+				int difCount = 0;	// track number of divergent attributes in current point
+				// Check each pair of elements from each vector for difference within threshold value
+				for (std::size_t attr = 0; attr < currPoint.size(); ++attr)
+				{
+					// If the absolute value of the difference of the pair of attributes
+					// is below the allowed minimum threshold value
+					if (abs(currPoint[attr] - point[attr]) >= MIN_THRESHOLD)
+					{
+						++difCount;	// Increment the difference count
+						if (difCount > ALLOWED_DIFFERENCES)
 						{
-							++difCount;	// Increment the difference count
-							if (difCount > ALLOWED_DIFFERENCES)
-							{	
-								// If the number of allowed differences has been exceeded
-								addThis = false;	// flag this data point as divergent from the center
-							}
+							// If the number of allowed differences has been exceeded
+							addThis = false;	// flag this data point as divergent from the center
 						}
-						// increment comparison vector iterator
-						it2++;
-					}
-					
-					// addThis = true;
-					// save for debugging
-					
-					// if flag was set to add this point
-					if (addThis)
-					{
-						mixedHood.push_back(*dataIt);	// add data point to analysis data vector
-						mixedClass.push_back(*classIt);	// add class to analysis class vector
 					}
 				}
 
-				// Add point to temp vector
-				tempData.push_back(*dataIt);
-
-				// Remove current point from vectors
-				dataIt = allData.erase(dataIt);
-				classIt = classifyCopy.erase(classIt);
-				threshIt = thresholds.erase(threshIt);
-			}
-			else
-			{	// Increment iterators
-				++dataIt;
-				++classIt;
-				++threshIt;
+				// if flag was set to add this point
+				if (addThis)
+				{
+					mixedHood.push_back(std::vector<GLfloat>(point.begin(), point.end()));	// add data point to analysis data vector
+					mixedClass.push_back(counts.dominant(rowId));	// add class to analysis class vector
+				}
 			}
 
-			if (dataIt == allData.end())
-			{	// Exit loop
-				break;
-			}
+			// Add point to current neighborhood
+			tempIds.push_back(rowId);
 		}
+		remaining.swap(unclustered);
 
-		// identify count of dominant class of cluster
-		float domCount = std::max(benCount, malCount);
-		// itentify total count of datapoints in cluster
-		float totalCount = benCount + malCount;
-
-		// calculate percent purity of cluster
-		float percentPure = (domCount / totalCount) * 100.0;
+		// calculate percent purity of cluster from the count of its dominant class
+		float percentPure = hoodClasses.purity() * 100.0;
 
 		// round label to three decimal places
 		std::string pureLabel1 = std::to_string(percentPure);
 		std::string pureLabel = pureLabel1.substr(0, 5);
 
 		// Add label to vector
-		labels.push_back(pureLabel + "%, n=" + std::to_string(benCount + malCount) + "");
-		repsSize.push_back(benCount + malCount);
+		labels.push_back(pureLabel + "%, n=" + std::to_string(hoodClasses.getTotal()) + "");
+		repsSize.push_back(hoodClasses.getTotal());
 		//labels.push_back(std::to_string(benCount) + " ben., " + std::to_string(malCount) + " mal.");
-		repsClass.push_back(benCount > malCount);
+		repsClass.push_back(hoodClasses.dominant());
 
 		// Initialize new rep vector
 		std::vector<GLfloat> repVec{};
 
-		/* Compute average glyph of neighborhood by taking tempData,
-		*  the set of vectors saved during clustering, and computing
-		*  the average value for each attribute from the data points
-		*  in the set.
+		/* Compute average glyph of neighborhood from the ids of
+		*  the vectors saved during clustering, averaging each
+		*  attribute over the data points in the set.
 		*/
-		for (unsigned int index = 0; index < MAX_SIG_INDEX; ++index)
-		{	// For the current index of each vector
-			GLfloat tempAttr = 0.0;
-			for (auto& vec : tempData)
-			{	// For each vector
-				tempAttr += vec[index];
-			}
-			// Compute average value from sum
-			tempAttr /= tempData.size();
-			// Add to representative point
-			repVec.push_back(tempAttr);
-		}
+		kernels->weightedCentroid(tempIds, counts.getWeights(), &repVec);
 
 		// Add representative vector to set
 		reps.push_back(repVec);
 
+		// Save bounding box of the neighborhood for overlap analysis
+		repsBlocks.push_back(Hyperblock::fromPoints(DataView(data.getRows(), tempIds),
+			hoodClasses.dominant(), "rep" + std::to_string(hoodCount)));
+		repsBlocks.back().size = hoodClasses.getTotal();
+
 		// Reset counters
-		benCount = 0;
-		malCount = 0;
+		hoodClasses.clear();
 		++hoodCount;
 	}
 
@@ -1575,126 +1978,85 @@ void getRepresentativeGlyphs(std::vector<std::vector<GLfloat>>* all_Data,
 }
 
 // create hyperblocks using MHyper algorithm
-void mergerHyperblock(std::vector<std::vector<GLfloat>>* all_Data, std::vector<bool>* classify)
+// (each row is weighted by its class counts)
+void mergerHyperblock(const DataView& data, const LabelColumn& classify, const RowCounts& counts)
 {
-	std::vector<std::vector<GLfloat>> allData(*all_Data);					// deep copy data
-	std::vector<bool> classifyCopy(*classify);
 	std::vector<bool> thresholds{};	// track hyperblock membership
 
-	bool addThis = false;	// add curr point to hyperblock flag
+	// Build dimension-specialized kernels once over the underlying rows
+	std::unique_ptr<RowKernels> kernels = makeRowKernels(data.getRows(), attributeThresholds(data[0].size()));
 
-	int passCount = 0;
-	int failCount = 0;
+	// Ids of the points not yet assigned to a hyperblock
+	std::vector<unsigned int> remaining(data.getIds());
+	std::vector<unsigned int> unclustered{};
+
+	// Class of the passing students saved from the third hyperblock
+	ClassLabel pass = classify.find("pass");
 
 	int count = 0;
-	while (allData.size() != 0)	// continue til all points are clustered
+	while (remaining.size() != 0)	// continue til all points are clustered
 	{
-		// Compute points within threshold
-		thresholds = computeAllDistances(&allData[0], &allData);
-
-		std::vector< std::vector<GLfloat>> tempData{};							// temp vec for average glyph
-		std::vector< std::vector<GLfloat>> tempDataPass{};
-		std::vector< std::vector<GLfloat>> tempDataFail{};
-		std::vector<std::vector<GLfloat>>::iterator dataIt = allData.begin();	// Initialize vector iterators
-		std::vector<bool>::iterator classIt = classifyCopy.begin();
-		std::vector<bool>::iterator threshIt = thresholds.begin();
+		// Compute points within threshold of the first remaining point
+		kernels->closeTo(remaining.front(), remaining, &thresholds);
 
-		// Save first point in cluster for comparison
-		std::vector<float> currPoint = (*dataIt);
+		std::vector<std::vector<unsigned int>> classIds(counts.getNumClasses());	// ids of each class in the hyperblock
+		ClassHistogram blockClasses(counts.getNumClasses());					// class counts of the hyperblock
+		unclustered.clear();
 
-		addThis = false;	// reset add curr point flag
-		// Use threshold values to remove points
-		while (dataIt != allData.end())
+		// Use threshold values to split off the hyperblock
+		for (std::size_t i = 0; i < remaining.size(); ++i)
 		{
-			addThis = false;
-
-			// If current point is in current neighborhood
-			if (*threshIt)
-			{
-				// Add class to class count
-				if (*classIt)
-				{
-					++passCount;
-					tempDataPass.push_back(*dataIt);
-					if (count == 2)
-					{
-						passStudents.push_back(*dataIt);
-					}
-				}
-				else if (!*classIt)
-				{
-					++failCount;
-					tempDataFail.push_back(*dataIt);
-				}
-				// Add point to temp vector
-				tempData.push_back(*dataIt);
-
-				// Remove current point from vectors
-				dataIt = allData.erase(dataIt);
-				classIt = classifyCopy.erase(classIt);
-				threshIt = thresholds.erase(threshIt);
-			}
-			else
-			{	// Increment iterators
-				++dataIt;
-				++classIt;
-				++threshIt;
+			unsigned int rowId = remaining[i];
+			if (!thresholds[i])
+			{	// Keep point for a later hyperblock
+				unclustered.push_back(rowId);
+				continue;
 			}
 
-			if (dataIt == allData.end())
-			{	// Exit loop
-				break;
+			// Add point to the ids of its class
+			classIds[counts.dominant(rowId)].push_back(rowId);
+			counts.addTo(rowId, &blockClasses);
+			if (count == 2 && counts.dominant(rowId) == pass)
+			{	// save passing students of the third hyperblock
+				RowView point = data.row(rowId);
+				passStudents.push_back(std::vector<GLfloat>(point.begin(), point.end()));
 			}
 		}
+		remaining.swap(unclustered);
 
 		++count;
-		studentLabels.push_back(std::to_string(passCount) + " pass, " + std::to_string(failCount) + " fail");
-		 
-		// Initialize new rep vector
-		std::vector<GLfloat> tempVec{};
 
-		/* Compute average glyph of neighborhood by taking tempData,
-		*  the set of vectors saved during clustering, and computing
-		*  the average value for each attribute from the data points
-		*  in the set.
-		*/
-		if (passCount > failCount)
-		{
-			for (unsigned int index = 0; index < 10; ++index)
-			{	// For the current index of each vector
-				GLfloat tempAttr = 0.0;
-				for (auto& vec : tempDataPass)
-				{	// For each vector
-					tempAttr += vec[index];
-				}
-				// Compute average value from sum
-				tempAttr /= tempDataPass.size();
-				// Add to representative point
-				tempVec.push_back(tempAttr);
-			}
-		}
-		else
+		// Label hyperblock with the count of each class, and find the class
+		// whose rows hold the most points
+		std::string blockLabel = "";
+		ClassLabel dominant = 0;
+		unsigned int dominantWeight = 0;
+		for (ClassLabel label = 0; label < classIds.size(); ++label)
 		{
-			for (unsigned int index = 0; index < 10; ++index)
-			{	// For the current index of each vector
-				GLfloat tempAttr = 0.0;
-				for (auto& vec : tempDataFail)
-				{	// For each vector
-					tempAttr += vec[index];
-				}
-				// Compute average value from sum
-				tempAttr /= tempDataFail.size();
-				// Add to representative point
-				tempVec.push_back(tempAttr);
+			if (label > 0) blockLabel += ", ";
+			blockLabel += std::to_string(blockClasses.count(label)) + " " + classify.name(label);
+
+			unsigned int classWeight = 0;
+			for (unsigned int rowId : classIds[label]) classWeight += counts.weight(rowId);
+			if (classWeight > dominantWeight)
+			{
+				dominant = label;
+				dominantWeight = classWeight;
 			}
 		}
+		studentLabels.push_back(blockLabel);
+
+		// Initialize new rep vector
+		std::vector<GLfloat> tempVec{};
+
+		/* Compute average glyph of the hyperblock from the ids of
+		*  its dominant class, averaging each attribute over the
+		*  data points in the set.
+		*/
+		kernels->weightedCentroid(classIds[dominant], counts.getWeights(), &tempVec);
 
 		// Add representative vector to set
 		studentHyperblocks.push_back(tempVec);
-
-		// Reset class counters
-		passCount = 0;
-		failCount = 0;
 	}
 
 	STUDENT_HYPER_COLLECTED = true;	// set collected flag
@@ -1714,12 +2076,16 @@ void openGLInit()
 }
 
 // IMPORT DATA
-void importData(std::vector<std::vector<GLfloat>>* allData, std::vector<bool>* classify)
+void importData(std::vector<std::vector<GLfloat>>* allData, LabelColumn* classify)
 {
 	// Read data file
 	std::string line = "";
 	std::ifstream myFile("breast-cancer-wisconsin.DATA");
 
+	// Register classes so that benign is always class 0
+	ClassLabel benign = classify->addClass("ben");
+	ClassLabel malignant = classify->addClass("mal");
+
 	for (unsigned int i = 0; i < DATA_SIZE; i++)
 	{
 		getline(myFile, line);
@@ -1741,8 +2107,8 @@ void importData(std::vector<std::vector<GLfloat>>* allData, std::vector<bool>* c
 		std::vector<GLfloat> data(dataInt.begin(), dataInt.end());
 
 		// Set color determined by class
-		if (*--(data.end()) == 4) classify->push_back(false);
-		else					  classify->push_back(true);
+		if (*--(data.end()) == 4) classify->push_back(malignant);
+		else					  classify->push_back(benign);
 
 		// Remove labels from data
 		data.erase(data.begin());
@@ -1759,7 +2125,7 @@ void importData(std::vector<std::vector<GLfloat>>* allData, std::vector<bool>* c
 }
 
 // IMPORT SEED DATA
-void importSeedData(std::vector<std::vector<GLfloat>>* allData)
+void importSeedData(std::vector<std::vector<GLfloat>>* allData, LabelColumn* classify)
 {
 	std::string line = "";
 	std::ifstream myFile("seeds_3.txt");
@@ -1774,73 +2140,452 @@ void importSeedData(std::vector<std::vector<GLfloat>>* allData)
 		std::vector<int> dataFloat;
 		std::stringstream ss(line);
 
-		while (ss.good()) {
-			std::string substr = "";
-			getline(ss, substr, '\t');	// extract line from file
-			dataFloat.push_back(stof(substr));	// convert to float and push to vector
-			continue;
-		}
+		while (ss.good()) {
+			std::string substr = "";
+			getline(ss, substr, '\t');	// extract line from file
+			dataFloat.push_back(stof(substr));	// convert to float and push to vector
+			continue;
+		}
+
+		// Move class attribute to label column
+		classify->push_back(std::to_string(dataFloat.back()));
+		dataFloat.pop_back();
+
+		std::vector<GLfloat> data(dataFloat.begin(), dataFloat.end());
+		(*allData)[i] = data;	// add data point to hyperblock vector
+	}
+		myFile.close();
+}
+
+// IMPORT STUDENT DATA
+void importStudentData(std::vector<std::vector<GLfloat>>* allData, LabelColumn* classify)
+{
+	std::string line = "";
+	std::ifstream myFile("student_new_2.txt");
+
+	// Register classes so that pass is always class 0
+	ClassLabel pass = classify->addClass("pass");
+	ClassLabel fail = classify->addClass("fail");
+
+
+	// For each line in the hyperblock data file
+	for (unsigned int i = 0; i < STUDENT_DATASET_SIZE; i++)
+	{
+		getline(myFile, line);
+		//int vecCount = SEED_DATA_SIZE;
+
+		// Split string into a vector
+		std::vector<int> dataFloat;
+		std::stringstream ss(line);
+
+		while (ss.good()) {
+			std::string substr = "";
+			getline(ss, substr, ',');	// extract line from file
+			dataFloat.push_back(stof(substr));	// convert to float and push to vector
+
+			continue;
+		}
+
+		std::vector<GLfloat> data(dataFloat.begin(), dataFloat.end());
+
+		// Set color determined by class
+		if (*--(data.end()) == 0) classify->push_back(pass);
+		else
+		{
+			classify->push_back(fail);
+		}
+
+		data.erase(--data.end());	// remove class label from datapoint
+
+		(*allData)[i] = data;	// add data point to hyperblock vector
+	}
+	myFile.close();
+}
+
+
+// IMPORT APPENDED DATA
+// Read every labelled row of a file in the WBC format (id, attributes, class).
+// Returns false, reading nothing, if the file cannot be opened or any row is
+// not all integers, has a missing ("?") value, or does not have the given width.
+bool importAppendedData(const std::string& fileName, std::size_t width, std::vector<std::vector<GLfloat>>* newData, LabelColumn* classify)
+{
+	std::string line = "";
+	std::ifstream myFile(fileName);
+	if (!myFile)	// Check that file was opened successfully
+	{
+		std::cout << "Error: " << fileName << " did not open.\n";
+		return false;
+	}
+
+	// Register classes in the same order as importData
+	ClassLabel benign = classify->addClass("ben");
+	ClassLabel malignant = classify->addClass("mal");
+
+	std::vector<std::vector<GLfloat>> rows{};
+	std::vector<ClassLabel> rowClass{};
+	unsigned int lineNumber = 0;
+	while (getline(myFile, line))
+	{
+		++lineNumber;
+		if (line.empty() || line == "\r") continue;
+
+		// Split string into a vector, rejecting anything but integers
+		std::vector<int> dataInt;
+		std::stringstream ss(line);
+		bool valid = true;
+		while (ss.good() && valid) {
+			std::string substr = "";
+			getline(ss, substr, ',');
+
+			std::istringstream sin(substr);
+			int value = 0;
+			sin >> value;
+			valid = !sin.fail() && (sin >> std::ws).eof();
+			dataInt.push_back(value);
+		}
+
+		// Id, attributes and class
+		if (!valid || dataInt.size() != width + 2)
+		{
+			std::cout << "Error: " << fileName << " line " << lineNumber << " is not an id, "
+				<< width << " attribute values and a class.\n";
+			return false;
+		}
+
+		std::vector<GLfloat> data(dataInt.begin() + 1, dataInt.end() - 1);
+		rowClass.push_back((dataInt.back() == 4) ? malignant : benign);
+		rows.push_back(data);
+	}
+	myFile.close();
+
+	newData->insert(newData->end(), rows.begin(), rows.end());
+	for (ClassLabel classLabel : rowClass) classify->push_back(classLabel);
+	return true;
+}
+
+/*
+updateHyperblockModel
+Insert newly arrived labelled rows into the hyperblock model saved
+in HB_MODEL_FILE, building the model from the WBC data set first if
+there is no saved model, and save it again. Only the new rows are
+inserted; existing blocks are grown or split in place instead of
+rerunning the clustering. The SPC-SF view shows the saved model.
+@param		fileName	file of new rows in the WBC format
+@return				0 if the rows were inserted and the model saved, 1 otherwise
+*/
+int updateHyperblockModel(const std::string& fileName)
+{
+	HyperblockModel hyperblockModel(THRESHOLD_VALUE);
+	if (!hyperblockModel.load(HB_MODEL_FILE))
+	{
+		std::vector<std::vector<GLfloat>> allData(DATA_SIZE);
+		LabelColumn classify{};
+		importData(&allData, &classify);
+		hyperblockModel.insertRows(allData, classify);
+		std::cout << hyperblockModel.getBlocks().size() << " hyperblocks from "
+			<< hyperblockModel.getRowCount() << " rows\n";
+	}
+
+	std::vector<std::vector<GLfloat>> newData{};
+	LabelColumn newClass{};
+	if (!importAppendedData(fileName, hyperblockModel.getWidth(), &newData, &newClass)) return 1;
+	hyperblockModel.insertRows(newData, newClass);
+
+	std::cout << hyperblockModel.getBlocks().size() << " hyperblocks after appending "
+		<< newData.size() << " rows\n";
+	if (!hyperblockModel.save(HB_MODEL_FILE))
+	{
+		std::cout << "Error: Could not write " << HB_MODEL_FILE << ".\n";
+		return 1;
+	}
+	return 0;
+}
+
+/*
+reportHyperblockOverlaps
+Compute every intersecting pair of hyperblocks from the HB*.csv
+catalog and from the representative glyph neighborhoods, and print
+the pairs whose blocks belong to different classes.
+@param			none
+@return			void
+*/
+void reportHyperblockOverlaps()
+{
+	// Import labelled data to recover catalog block classes
+	std::vector<std::vector<GLfloat>> allData(DATA_SIZE);
+	LabelColumn classify{};
+	importData(&allData, &classify);
+	RowCounts rowCounts = deduplicateRows(&allData, &classify);
+
+	std::vector<Hyperblock> blocks = importHyperblockCatalog("hyperblocks", MAX_SIG_INDEX);
+	classifyHyperblocks(&blocks, allData, rowCounts);
+
+	// Add generated neighborhoods to the catalog blocks
+	if (!REPS_COLLECTED)
+	{
+		getRepresentativeGlyphs(DataView(allData), rowCounts);
+	}
+	blocks.insert(blocks.end(), repsBlocks.begin(), repsBlocks.end());
+
+	HyperblockOverlap overlap = HyperblockOverlap();
+	std::vector<HyperblockOverlap::OverlapPair> pairs = overlap.compute(blocks);
+
+	int mixedCount = 0;
+	for (const auto& pair : pairs)
+	{
+		if (!pair.mixedClass) continue;
+		++mixedCount;
+		std::cout << blocks[pair.first].label << " (" << classify.name(blocks[pair.first].classLabel) << ") x "
+			<< blocks[pair.second].label << " (" << classify.name(blocks[pair.second].classLabel) << ")"
+			<< "  volume=" << pair.volume << "\n";
+	}
+
+	std::cout << blocks.size() << " hyperblocks, " << pairs.size() << " intersecting pairs, "
+		<< mixedCount << " between different classes\n";
+	if (overlap.getSkipped() > 0)
+	{
+		std::cout << "Error: Skipped " << overlap.getSkipped() << " empty hyperblocks or hyperblocks of another dimension.\n";
+	}
+}
+
+/*
+reportOverlapRisk
+Find every pair of WBC points of different classes that overlap
+within the configured tolerances, and print the points most at
+risk of misclassification.
+@param			none
+@return			void
+*/
+void reportOverlapRisk()
+{
+	std::vector<std::vector<GLfloat>> allData(DATA_SIZE);
+	LabelColumn classify{};
+	importData(&allData, &classify);
+
+	OverlapRegions overlap(overlapTolerances(MAX_SIG_INDEX));
+	std::vector<OverlapRegions::CrossClassPair> pairs = overlap.compute(DataView(allData), classify);
+	const std::vector<GLfloat>& risk = overlap.getRisk();
+
+	// Order the points at risk from most to least
+	std::vector<unsigned int> atRisk{};
+	for (unsigned int i = 0; i < risk.size(); ++i)
+	{
+		if (risk[i] > 0.0) atRisk.push_back(i);
+	}
+	std::stable_sort(atRisk.begin(), atRisk.end(),
+		[&](unsigned int lhs, unsigned int rhs) { return risk[lhs] > risk[rhs]; });
+
+	for (std::size_t i = 0; i < atRisk.size() && i < 10; ++i)
+	{
+		std::cout << "row " << atRisk[i] << " (" << classify.name(classify[atRisk[i]]) << ")"
+			<< "  risk=" << risk[atRisk[i]] << "\n";
+	}
+
+	std::cout << allData.size() << " points, " << pairs.size() << " cross-class pairs, "
+		<< atRisk.size() << " points at risk\n";
+}
+
+/*
+reportBestMapping
+Search for the glyph mapping that best separates the classes of a
+data set, and print it as config.config entries.
+@param			dataset		WBC or STUDENT
+@return			void
+*/
+void reportBestMapping(const std::string& dataset)
+{
+	std::vector<std::vector<GLfloat>> allData{};
+	LabelColumn classify{};
+	GlyphMapping initial = WBC_MAPPING;
+	if (dataset == "STUDENT")
+	{
+		allData.resize(STUDENT_DATASET_SIZE);
+		importStudentData(&allData, &classify);
+		initial = STUDENT_MAPPING;
+	}
+	else
+	{
+		allData.resize(DATA_SIZE);
+		importData(&allData, &classify);
+	}
+	RowCounts counts = deduplicateRows(&allData, &classify);
+
+	MappingOptimizer optimizer{};
+	GlyphMapping best = optimizer.optimize(DataView(allData), counts, allData[0].size(), initial);
 
-		// Remove class attribute
-		dataFloat.pop_back();
+	std::cout << dataset << "_GLYPH_POSITION = " << best.format("POSITION") << "\n";
+	std::cout << dataset << "_GLYPH_SF = " << best.format("SF") << "\n";
+	std::cout << "position score " << optimizer.getScore() << " over " << allData.size() << " unique rows\n";
+}
 
-		std::vector<GLfloat> data(dataFloat.begin(), dataFloat.end());
-		(*allData)[i] = data;	// add data point to hyperblock vector
+// vector comparison function to determine the sum of differences between two vectors
+GLfloat compareHyperblocks(const std::vector<GLfloat>& vec1, const std::vector<GLfloat>& vec2) {
+	GLfloat sumDifference = 0.0;
+	// sum all differences between attributes of the vectors together.
+	for (std::size_t i = 0; i < vec1.size(); ++i) {
+		sumDifference += std::abs(vec1[i] - vec2[i]);
 	}
-		myFile.close();
+	// return the sum of the differences
+	return sumDifference;
 }
 
-// IMPORT STUDENT DATA
-void importStudentData(std::vector<std::vector<GLfloat>>* allData, std::vector<bool>* classify)
+/*
+reportClutter
+Measure the overlap, per-class occlusion and edge visibility of the
+glyphs the SPC-SF view displays, laid out with the configured mapping
+and with the best mapping found by the optimizer. The view shows every
+row if DISPLAY_ALL is set, else the testing point of an exported view
+and its most similar representative glyphs. A row's glyph is weighted
+by the data points it stands for; a representative glyph counts once.
+@param			none
+@return			void
+*/
+void reportClutter()
 {
-	std::string line = "";
-	std::ifstream myFile("student_new_2.txt");
-
+	std::vector<std::vector<GLfloat>> allData(DATA_SIZE);
+	LabelColumn classify{};
+	importData(&allData, &classify);
+	RowCounts counts = deduplicateRows(&allData, &classify);
 
-	// For each line in the hyperblock data file
-	for (unsigned int i = 0; i < STUDENT_DATASET_SIZE; i++)
+	// Split the rows as an exported view does, and collect the glyphs of the training rows it compares against
+	std::mt19937 g(RENDER_SEED);
+	std::vector<unsigned int> shuffledIds(allData.size());
+	for (unsigned int i = 0; i < shuffledIds.size(); ++i) shuffledIds[i] = i;
+	std::shuffle(shuffledIds.begin(), shuffledIds.end(), g);
+	std::size_t splitIndex = (allData.size() * 0.9);
+	if (!DISPLAY_ALL)
 	{
-		getline(myFile, line);
-		//int vecCount = SEED_DATA_SIZE;
+		std::vector<unsigned int> trainingIds(shuffledIds.begin(), shuffledIds.begin() + splitIndex);
+		if (IDEAL_GLYPHS) getIdealGlyphs(DataView(allData, trainingIds), classify, counts);
+		getRepresentativeGlyphs(DataView(allData, trainingIds), counts);
+	}
 
-		// Split string into a vector
-		std::vector<int> dataFloat;
-		std::stringstream ss(line);
+	for (auto& row : allData)
+	{
+		for (auto& value : row) value /= 10;	// normalize to [0, 1] as drawn
+	}
 
-		while (ss.good()) {
-			std::string substr = "";
-			getline(ss, substr, ',');	// extract line from file
-			dataFloat.push_back(stof(substr));	// convert to float and push to vector
+	// Displayed glyphs with their classes and weights
+	std::vector<std::vector<GLfloat>> glyphs{};
+	std::vector<ClassLabel> glyphClasses{};
+	std::vector<unsigned int> glyphWeights{};
+	if (DISPLAY_ALL)
+	{
+		glyphs = allData;
+		glyphClasses = classify.getLabels();
+		glyphWeights = counts.getWeights();
+	}
+	else
+	{
+		// Testing point of the view, then the glyphs nearest to it, each drawn once
+		unsigned int testId = shuffledIds[splitIndex + DATA_INDEX % (allData.size() - splitIndex)];
+		glyphs.push_back(allData[testId]);
+		glyphClasses.push_back(classify[testId]);
+		glyphWeights.push_back(counts.weight(testId));
 
-			continue;
+		std::vector<std::size_t> nearest(reps.size());
+		for (std::size_t i = 0; i < nearest.size(); ++i) nearest[i] = i;
+		std::sort(nearest.begin(), nearest.end(), [&](std::size_t lhs, std::size_t rhs)
+		{
+			return compareHyperblocks(allData[testId], reps[lhs]) < compareHyperblocks(allData[testId], reps[rhs]);
+		});
+		for (std::size_t i = 0; i < std::min<std::size_t>(5, nearest.size()); ++i)
+		{
+			glyphs.push_back(reps[nearest[i]]);
+			glyphClasses.push_back(repsClass[nearest[i]]);
+			glyphWeights.push_back(1);
 		}
+	}
 
-		std::vector<GLfloat> data(dataFloat.begin(), dataFloat.end());
+	MappingOptimizer optimizer{};
+	GlyphMapping optimized = optimizer.optimize(DataView(allData), counts, MAX_SIG_INDEX, WBC_MAPPING);
+	const GlyphMapping* layouts[2] = { &WBC_MAPPING, &optimized };
+	const char* names[2] = { "configured", "optimized" };
 
-		// Set color determined by class
-		if (*--(data.end()) == 0) classify->push_back(true);
-		else
+	std::cout << glyphs.size() << " glyphs displayed\n";
+	for (unsigned int l = 0; l < 2; ++l)
+	{
+		GlyphGeometry geometry{};
+		geometry.compute(DataView(glyphs), *layouts[l], currentGlyphLayout(), DYNAMIC_ANGLES, POS_ANGLE, ANGLE_FOCUS);
+
+		ClutterMetric clutter(SCREEN_WIDTH, SCREEN_HEIGHT);
+		clutter.compute(geometry, currentGlyphLayout().viewportSize(), glyphClasses, glyphWeights, classify.numClasses());
+
+		std::cout << names[l] << " layout (" << layouts[l]->format("POSITION") << "): overlap="
+			<< clutter.getOverlapRatio() << "  visible edges=" << clutter.getVisibleEdges();
+		for (ClassLabel label = 0; label < classify.numClasses(); ++label)
 		{
-			classify->push_back(false);
+			std::cout << "  " << classify.name(label) << " occlusion=" << clutter.getOcclusion(label);
 		}
+		std::cout << "\n";
+	}
+}
 
-		data.erase(--data.end());	// remove class label from datapoint
-
-		(*allData)[i] = data;	// add data point to hyperblock vector
+/*
+printTreeNode
+Print a decision tree node and the nodes below it, one per line,
+indented by depth.
+@param		tree		Trained decision tree
+			node		Node to print
+			depth		Depth of the node
+			classify	Class names
+@return					void
+*/
+void printTreeNode(const DecisionTree& tree, int node, unsigned int depth, const LabelColumn& classify)
+{
+	const DecisionTree::Node& current = tree.getNodes()[node];
+	std::cout << std::string(2 * depth, ' ');
+	if (current.attribute < 0)
+	{
+		std::cout << classify.name(current.classLabel) << " (" << current.weight << " points)\n";
+		return;
 	}
-	myFile.close();
+	std::cout << "x" << current.attribute << " < " << current.threshold << " (" << current.weight << " points)\n";
+	printTreeNode(tree, current.left, depth + 1, classify);
+	std::cout << std::string(2 * depth, ' ') << "x" << current.attribute << " >= " << current.threshold << "\n";
+	printTreeNode(tree, current.right, depth + 1, classify);
 }
 
+/*
+reportDecisionTree
+Train the decision tree drawn as hypercubes on a data set, and
+print it with its training accuracy and training time.
+@param			dataset		WBC or STUDENT
+@return			void
+*/
+void reportDecisionTree(const std::string& dataset)
+{
+	std::vector<std::vector<GLfloat>> allData{};
+	LabelColumn classify{};
+	if (dataset == "STUDENT")
+	{
+		allData.resize(STUDENT_DATASET_SIZE);
+		importStudentData(&allData, &classify);
+	}
+	else
+	{
+		allData.resize(DATA_SIZE);
+		importData(&allData, &classify);
+	}
+	RowCounts counts = deduplicateRows(&allData, &classify);
 
-// vector comparison function to determine the sum of differences between two vectors
-GLfloat compareHyperblocks(const std::vector<GLfloat>& vec1, const std::vector<GLfloat>& vec2) {
-	GLfloat sumDifference = 0.0;
-	// sum all differences between attributes of the vectors together.
-	for (std::size_t i = 0; i < vec1.size(); ++i) {
-		sumDifference += std::abs(vec1[i] - vec2[i]);
+	std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+	DecisionTree tree(TREE_DEPTH, TREE_MIN_LEAF);
+	tree.train(DataView(allData), counts);
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+	// Weighted share of data points whose leaf has their class
+	unsigned int correct = 0;
+	unsigned int total = 0;
+	for (std::size_t row = 0; row < allData.size(); ++row)
+	{
+		correct += counts.count(row, tree.predict(RowView(allData[row])));
+		total += counts.weight(row);
 	}
-	// return the sum of the differences
-	return sumDifference;
+
+	printTreeNode(tree, 0, 0, classify);
+	std::cout << tree.leafBlocks(DataView(allData)).size() << " leaves, training accuracy "
+		<< (total > 0 ? 100.0 * correct / total : 0.0) << "%, trained in " << milliseconds << " ms\n";
 }
 
 // *********************** Display SPC-SF Hybrid Visualization ***********************
@@ -1853,13 +2598,16 @@ void myDisplay()
 	std::vector<std::vector<std::vector<GLfloat>>> hyperblocks{};
 
 	// seed container
+	LabelColumn seedClass{};
 	std::vector<std::vector<GLfloat>> seeds(27);
-	importSeedData(&seeds);
+	importSeedData(&seeds, &seedClass);
 
 	// student container
-	std::vector<bool> studentClass{};
+	LabelColumn studentClass{};
 	std::vector<std::vector<GLfloat>> students(STUDENT_DATASET_SIZE);
 	importStudentData(&students, &studentClass);
+	// Collapse repeated students into weighted unique rows
+	RowCounts studentCounts = deduplicateRows(&students, &studentClass);
 	// Normalize student data
 	unsigned int index = 0;
 	for (auto& vec : students)
@@ -1880,62 +2628,98 @@ void myDisplay()
 
 	// Process data into a 2-D vector for ease of use
 	std::vector<std::vector<GLfloat>> allData(DATA_SIZE);
-	std::vector<bool> classify{};	//  vector containing class of data points
+	LabelColumn classify{};		//  column containing class of data points
 
 	// import data from csv file
 	importData(&allData, &classify);
 
+	// Collapse repeated data points into unique rows weighted by their class counts
+	RowCounts rowCounts = deduplicateRows(&allData, &classify);
+
+	// Keep the current index within the unique rows
+	UNIQUE_DATA_SIZE = (unsigned int)allData.size();
+	DATA_INDEX = std::min(DATA_INDEX, UNIQUE_DATA_SIZE - 1);
+
 	//*****************************************************************
 	// import HB1 (first hyperblock from Lincoln)
 	std::vector<std::vector<GLfloat>> hb1(HYPERBLOCK_SIZE);
 	importHyperblockData(&hb1);
-	std::vector<bool> hbClass = std::vector<bool>(HYPERBLOCK_SIZE, HB_CLASS);
 
 	// SPLIT DATA VECTOR 90/10
 	std::random_device rd;	// initialize random number generator
-	std::mt19937 g(rd());	// ensure different seeds for different runs
+	std::mt19937 g(HEADLESS ? RENDER_SEED : rd());	// ensure different seeds for different runs, but not for exported views
 
-	// Randomly shuffle the elements of the data vector
-	std::shuffle(allData.begin(), allData.end(), g);
+	// Randomly shuffle the ids of the data, keeping rows aligned with their classes
+	std::vector<unsigned int> shuffledIds(allData.size());
+	for (unsigned int i = 0; i < shuffledIds.size(); ++i) shuffledIds[i] = i;
+	std::shuffle(shuffledIds.begin(), shuffledIds.end(), g);
 
 	// Determine what index to split the shuffled data vector
 	std::size_t dataSize = allData.size();
 	std::size_t splitIndex = (dataSize * 0.9);
 
-	// Initialize training and testing vectors
-	std::vector<std::vector<GLfloat>> trainingData(splitIndex);
-	std::vector<std::vector<GLfloat>> testingData(dataSize - splitIndex);
-
-	// Copy data from allData into training (90%) and testing (10%) vectors
-	std::copy(allData.begin(), allData.begin() + splitIndex, trainingData.begin());
-	std::copy(allData.begin() + splitIndex, allData.end(), testingData.begin());
+	// Training (90%) and testing (10%) sets are the shuffled ids on either side of the split
+	std::vector<unsigned int> trainingIds(shuffledIds.begin(), shuffledIds.begin() + splitIndex);
 
 	// ONE TIME OPERATIONS
-	//if (!IDEAL_COLLECTED)	// Collect ideal class glyphs, if not done
-		//getIdealGlyphs(&allData, &classify);
+	if (treeBlocks.empty())	// Train the decision tree, then scale its leaf regions as the data is drawn
+	{
+		DecisionTree tree(TREE_DEPTH, TREE_MIN_LEAF);
+		tree.train(DataView(allData, trainingIds), rowCounts);
+		treeBlocks = tree.leafBlocks(DataView(allData, trainingIds));
+		for (auto& block : treeBlocks)
+		{
+			for (auto& value : block.lower) value /= 10;
+			for (auto& value : block.upper) value /= 10;
+		}
+	}
+	if (envelopeBlocks.empty())	// Load the saved hyperblock model, or else classify the hyperblock catalog, then scale it as the data is drawn
+	{
+		HyperblockModel hyperblockModel(THRESHOLD_VALUE);
+		if (hyperblockModel.load(HB_MODEL_FILE))
+		{
+			envelopeBlocks = hyperblockModel.getBlocks();
+		}
+		else
+		{
+			envelopeBlocks = importHyperblockCatalog("hyperblocks", MAX_SIG_INDEX);
+			classifyHyperblocks(&envelopeBlocks, allData, rowCounts);
+		}
+		for (auto& block : envelopeBlocks)
+		{
+			for (auto& value : block.lower) value /= 10;
+			for (auto& value : block.upper) value /= 10;
+		}
+	}
+
+	if (IDEAL_GLYPHS && !IDEAL_COLLECTED)	// Collect ideal class glyphs, if enabled and not done, to lead the grid of representative glyphs
+		getIdealGlyphs(DataView(allData, trainingIds), classify, rowCounts);
 
 	if (!REPS_COLLECTED)	// Collect representative glyphs, if not already done
 	{
-		//getRepresentativeGlyphs(&allData, &classify);
-		getRepresentativeGlyphs(&trainingData, &classify);
+		//getRepresentativeGlyphs(DataView(allData), rowCounts);
+		getRepresentativeGlyphs(DataView(allData, trainingIds), rowCounts);
 	}
 	if (!STUDENT_HYPER_COLLECTED)
 	{
-		mergerHyperblock(&students, &studentClass);
+		mergerHyperblock(DataView(students), studentClass, studentCounts);
 	}
 
-	analyzeGlyphShape(&allData, &classify);
-	index = 0;
-	for (auto& vec : analyzeGlyphs)
+	if (!ANALYZE_COLLECTED)	// Collect glyphs at risk of misclassification, if not already done
 	{
-		const unsigned int scaleFactor = 10;
-		std::vector<float> normalData;		// Normalize data to [0, 1]
-		for (std::vector<float>::iterator iter = vec.begin(); iter < vec.end(); iter++)
+		analyzeGlyphShape(DataView(allData), rowCounts);
+		index = 0;
+		for (auto& vec : analyzeGlyphs)
 		{
-			normalData.push_back(*iter / scaleFactor);
+			const unsigned int scaleFactor = 10;
+			std::vector<float> normalData;		// Normalize data to [0, 1]
+			for (std::vector<float>::iterator iter = vec.begin(); iter < vec.end(); iter++)
+			{
+				normalData.push_back(*iter / scaleFactor);
+			}
+			analyzeGlyphs[index] = normalData;
+			++index;
 		}
-		analyzeGlyphs[index] = normalData;
-		++index;
 	}
 
 	// Compute points within threshold
@@ -1956,12 +2740,6 @@ void myDisplay()
 		++index;
 	}
 
-	// Replicate seed data attributes
-	for (auto& vec : seeds)
-	{
-		vec.insert(vec.end(), vec.begin(), vec.end());
-	}
-
 	// Normalize data
 	index = 0;
 	for (auto& vec : allData)
@@ -1976,35 +2754,6 @@ void myDisplay()
 		++index;
 	}
 
-	// Normalize data
-	index = 0;
-	for (auto& vec : testingData)
-	{
-		const unsigned int scaleFactor = 10;
-		std::vector<float> normalData;		// Normalize data to [0, 1]
-		for (std::vector<float>::iterator iter = vec.begin(); iter < vec.end(); iter++)
-		{
-			normalData.push_back(*iter / scaleFactor);
-		}
-		testingData[index] = normalData;
-		++index;
-	}
-
-	// Normalize data
-	index = 0;
-	for (auto& vec : trainingData)
-	{
-		const unsigned int scaleFactor = 10;
-		std::vector<float> normalData;		// Normalize data to [0, 1]
-		for (std::vector<float>::iterator iter = vec.begin(); iter < vec.end(); iter++)
-		{
-			normalData.push_back(*iter / scaleFactor);
-		}
-		trainingData[index] = normalData;
-		++index;
-	}
-
-
 	// normalize hyperblock data
 	index = 0;
 	for (auto& vec : hb1)
@@ -2019,14 +2768,12 @@ void myDisplay()
 		++index;
 	}
 
-	// Randomly pick a data point from the testing data
-	std::uniform_int_distribution<std::size_t> distribution(0, testingData.size() - 1);
-	std::size_t randomIndex = distribution(g);  // g is the random number generator
+	// Randomly pick a data point from the testing data, or the one at the data index for exported views
+	std::uniform_int_distribution<std::size_t> distribution(splitIndex, dataSize - 1);
+	std::size_t randomIndex = HEADLESS ? splitIndex + DATA_INDEX % (dataSize - splitIndex) : distribution(g);
 
 	// Save chosen point 
-	std::vector<GLfloat> testingDataPoint = testingData[randomIndex];
-	// Remove from testing data
-	testingData.erase(testingData.begin() + randomIndex);
+	const std::vector<GLfloat>& testingDataPoint = allData[shuffledIds[randomIndex]];
 
 	// Create a priority queue to save the top five most similar points to the chosen testing point
 	std::priority_queue<std::vector<GLfloat>, std::vector<std::vector<GLfloat>>, decltype(compareHyperblocks)*> similarVectors(compareHyperblocks);
@@ -2037,11 +2784,12 @@ void myDisplay()
 	{
 		std::vector<GLfloat> vector;
 		std::string label;
+		ClassLabel classLabel;
 		GLfloat sumDifference;
 
 		// VectorData constructor
-		VectorData(const std::vector<GLfloat>& v, const std::string& l, GLfloat sd)
-			: vector(v), label(l), sumDifference(sd)
+		VectorData(const std::vector<GLfloat>& v, const std::string& l, ClassLabel c, GLfloat sd)
+			: vector(v), label(l), classLabel(c), sumDifference(sd)
 		{}
 	};
 
@@ -2056,8 +2804,8 @@ void myDisplay()
 		const auto& label = labels[i];
 		// Compute sum difference of current vector to testing data
 		GLfloat sumDifference = compareHyperblocks(testingDataPoint, vector);
-		// Save vector, label, and difference in differences
-		differences.emplace_back(vector, label, sumDifference);
+		// Save vector, label, class, and difference in differences
+		differences.emplace_back(vector, label, repsClass[i], sumDifference);
 	}
 
 	/*
@@ -2084,6 +2832,7 @@ void myDisplay()
 	// Extract the top five most similar vectors
 	std::vector<std::vector<GLfloat>> mostSimilarVectors;
 	std::vector<std::string> mostSimilarLabels;
+	std::vector<ClassLabel> mostSimilarClasses;
 
 	/*
 	// extract most similar vectors, checking if total is less than 5 for errors
@@ -2103,24 +2852,31 @@ void myDisplay()
 		const auto& label = differences[i].label;
 		mostSimilarVectors.push_back(vector);
 		mostSimilarLabels.push_back(label);
+		mostSimilarClasses.push_back(differences[i].classLabel);
 	}
 	// Insert chosen training vector to front of most similar vectors for analysis
 	mostSimilarVectors.insert(mostSimilarVectors.begin(), testingDataPoint);
 	mostSimilarLabels.insert(mostSimilarLabels.begin(), "unlabeled");
+	mostSimilarClasses.insert(mostSimilarClasses.begin(), classify[shuffledIds[randomIndex]]);
 
-	std::vector<bool> analyzeClass(analyzeGlyphs.size(), false);
-	analyzeClass[0] = true;
+	// Glyphs of the SPC-SF view: every row if DISPLAY_ALL is set, else the chosen point and its most similar glyphs
+	const std::vector<std::vector<GLfloat>>& viewGlyphs = DISPLAY_ALL ? allData : mostSimilarVectors;
+	const std::vector<ClassLabel>& viewClasses = DISPLAY_ALL ? classify.getLabels() : mostSimilarClasses;
 
-	std::vector<std::string> analyzeLabels(analyzeGlyphs.size(), "mal");
-	analyzeLabels[0] = "ben";
+	// Label analyzed glyphs with their class and risk
+	std::vector<std::string> analyzeLabels{};
+	for (std::size_t i = 0; i < analyzeGlyphs.size(); ++i)
+	{
+		analyzeLabels.push_back(classify.name(analyzeClass[i]) + " " + std::to_string(analyzeRisk[i]).substr(0, 4));
+	}
 	
 	// Find average of all points in current hyperblock, to show as a representative glyph
 	std::vector<bool>::iterator currHB = close.begin();
 
 	// Copy data vector
 	std::vector<std::vector<GLfloat>>::iterator dataIt = (allData.begin());
-	// Copy class vector
-	std::vector<bool>::iterator hbClassIt = classify.begin();
+	// Row id of current data point
+	std::size_t rowId = 0;
 
 	sizeHB = 0;	// Reset global values
 	for (auto& attr : averagePoint)
@@ -2129,42 +2885,30 @@ void myDisplay()
 	}
 
 	// Determine size and composition of hyperblock
-	int benCount = 0;
-	int malCount = 0;
+	ClassHistogram hbClasses(classify.numClasses());
 	// iterate through all data points
 	for (currHB; currHB != close.end(); ++currHB)
 	{
 		// if current point is in hyperblock
 		if (*currHB)
 		{
-			// Add class to class count
-			if (*hbClassIt)
-			{
-				++benCount;
-			}
-			else if (!*hbClassIt)
-			{
-				++malCount;
-			}
+			// Add class counts of point to class count
+			rowCounts.addTo(rowId, &hbClasses);
 
-			++sizeHB;	// increment size counter
+			sizeHB += rowCounts.weight(rowId);	// increment size counter
 			// point is in current hyperblock
-			// add point to sum of all points
+			// add point to sum of all points, once per copy
 			for (unsigned int i = 0; i <9; ++i)
 			{
-				averagePoint[i] += (*dataIt)[i];
+				averagePoint[i] += (*dataIt)[i] * rowCounts.weight(rowId);
 			}
 		}
-		++hbClassIt;
+		++rowId;
 		++dataIt;	// increment iterator
 	}
 
-	// identify count of dominant class of cluster
-	float domCount = std::max(benCount, malCount);
-	// itentify total count of datapoints in cluster
-	float totalCount = benCount + malCount;
-	// calculate percent purity of cluster
-	float percentPure = (domCount / totalCount) * 100.0;
+	// calculate percent purity of cluster from the count of its dominant class
+	float percentPure = hbClasses.purity() * 100.0;
 
 	// round label to three decimal places
 	std::string pureLabel1 = std::to_string((int)percentPure);
@@ -2190,19 +2934,43 @@ void myDisplay()
 
 	sizeHB = 6;
 	std::vector<bool>::iterator threshold = close.begin();		// initialize threshold iterator
-	std::vector<bool>::iterator classVec = classify.begin();	// initialize class iterator
-	std::vector<int> tempSize = std::vector<int>(allData.size(), 1);
-	std::vector<int>::iterator sizeVec = tempSize.begin();
-	//std::vector<int>::iterator sizeVec = repsSize.begin();
+	std::vector<ClassLabel>::const_iterator classVec = classify.begin();	// initialize class iterator
 
 	// ************************************* DISPLAY SPC-SF GRAPH ***************************************
 	if (DISPLAY_SELECTOR)
 	{
+		// Static frames first, so every glyph is drawn over them
+		drawSpcFrameLayer();
+
+		// Hyperblock boxes under the glyphs
+		if (DISPLAY_HYPERCUBES)
+		{
+			displayHypercubes(classify.numClasses());
+		}
+
+		// Pick the glyph detail that fits the frame budget
+		glyphDetail.select(currentGlyphLayout().viewportSize(), viewGlyphs.size());
+
+		// Trace every located glyph in parallel before drawing
+		locatedGeometry.compute(DataView(viewGlyphs), WBC_MAPPING, currentGlyphLayout(),
+			DYNAMIC_ANGLES, POS_ANGLE, ANGLE_FOCUS);
+
+		// The density image stands in for every located glyph
+		if (DENSITY_VIEW)
+		{
+			drawDensityView(locatedGeometry, viewClasses, classify.numClasses());
+		}
+
+		// Time the glyph drawing alone for the next frame's detail, after the GL has finished the background
+		bool timeGlyphs = GLYPH_LOD && !DENSITY_VIEW;
+		if (timeGlyphs) glFinish();
+		std::chrono::steady_clock::time_point glyphsStarted = std::chrono::steady_clock::now();
+
 		int iteration = 1;
 		// Display points within threshold
 		// Pass through twice: Draw classes sequentially depending on CLASS_SEPERATION_MODE flag
-		for (std::vector<std::vector<GLfloat>>::iterator it = (mostSimilarVectors.begin());
-			it < mostSimilarVectors.end(); ++it)
+		for (std::vector<std::vector<GLfloat>>::const_iterator it = (viewGlyphs.begin());
+			it < viewGlyphs.end() && !DENSITY_VIEW; ++it)
 		{
 			// Display the point if DISPLAY_ALL flag is set,
 			// or if it is in the threshold of the current point
@@ -2217,17 +2985,49 @@ void myDisplay()
 				glLoadIdentity();
 				gluPerspective(0, float(SCREEN_WIDTH) / float(SCREEN_HEIGHT), 0.1, 100.0);
 
-				drawLocatedGlyphs(&(*it), *classVec, *sizeVec, iteration, hbLabel, hbLabel2);
+				drawLocatedGlyphs(RowView(*it), WBC_MAPPING, locatedGeometry, it - viewGlyphs.begin(),
+					viewClasses[it - viewGlyphs.begin()], iteration, hbLabel, hbLabel2);
 				++iteration;
 			}
 			// don't iterate past end of vectors
-			if (it != mostSimilarVectors.end())
+			if (it != viewGlyphs.end())
 			{
-				++sizeVec;
-				++classVec;
 				++threshold;
 			}
 		}
+
+		// Bundle the edges of every glyph together, under the glyphs
+		if (BUNDLE_EDGES && DRAW_EDGES && currentGlyphDetail() <= GlyphDetail::Edge && !DENSITY_VIEW)
+		{
+			batchBundledEdges(locatedGeometry, viewClasses);
+			if (!BATCH_GLYPHS) drawGlyphBatches();
+		}
+
+		// Draw every batched glyph of the frame at once
+		if (BATCH_GLYPHS)
+		{
+			drawGlyphBatches();
+		}
+
+		// Draw every glyph of the frame in one instanced call per primitive kind
+		if (GPU_GLYPHS && glyphRenderer.isReady() && !DENSITY_VIEW)
+		{
+			drawGlyphInstances(DataView(viewGlyphs));
+		}
+
+		// At the lowest detail, every glyph is a point
+		if (currentGlyphDetail() == GlyphDetail::Point && !DENSITY_VIEW)
+		{
+			drawDensityPoints(locatedGeometry, viewClasses);
+		}
+
+		// Wait for the GL to finish so the measured time covers drawing, not just issuing it
+		if (timeGlyphs)
+		{
+			glFinish();
+			glyphDetail.record(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - glyphsStarted).count(),
+				viewGlyphs.size());
+		}
 		/*
 		// Reset iterators for second pass through data
 		threshold = close.begin();
@@ -2255,7 +3055,7 @@ void myDisplay()
 		// If flag is set, display hypercubes
 		if (DISPLAY_HYPERCUBES)
 		{
-			displayHypercubes();
+			displayHypercubes(classify.numClasses());
 			glPopMatrix();
 		}
 	
@@ -2277,9 +3077,9 @@ void myDisplay()
 		// Construct glyph tool
 		SpcSfGlyph glyph = SpcSfGlyph();
 		// Construct turtle tool
-		TurtleG* turt = new TurtleG();
-		Point2* pos2 = new Point2();
-		Point2* pos3 = new Point2();
+		TurtleG turt = TurtleG();
+		Point2 pos2 = Point2();
+		Point2 pos3 = Point2();
 
 		// Initialize data iterator
 		std::vector<std::vector<GLfloat>>::iterator it = allData.begin();
@@ -2303,26 +3103,15 @@ void myDisplay()
 					glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
 					// Pointer to current data point
-					std::vector<GLfloat> processedData = *it;
+					const std::vector<GLfloat>& processedData = *it;
 
 					// Encode angles with most meaningful attributes
-					std::vector<GLfloat> stickFig{};
-					// Populate: CL (angle), UC (length), BN (angle), BC (length)
-					stickFig.push_back(*processedData.begin());			// Angle 1
-					stickFig.push_back(*(processedData.begin() + 1));	// Length 1
-					stickFig.push_back(*(processedData.begin() + 5));	// Angle 2
-					stickFig.push_back(*(processedData.begin() + 6));	// Length 2
+					GLfloat stickFig[4];
+					WBC_MAPPING.stickFigure(processedData, stickFig);
 
-					std::vector<GLfloat> axesSPC{};
-				
-					// Populate: UCsh, MA, SIN, MA, NN, MIT
-					// (MA, UCsh) (MA, SIN) (MIT, NN)
-					axesSPC.push_back(*(processedData.begin() + 3));	// X1
-					axesSPC.push_back(*(processedData.begin() + 2));	// Y1
-					axesSPC.push_back(*(processedData.begin() + 3));	// X2
-					axesSPC.push_back(*(processedData.begin() + 4));	// Y2
-					axesSPC.push_back(*(processedData.begin() + 8));	// X3
-					axesSPC.push_back(*(processedData.begin() + 7));	// Y3
+					// Encode SPC axes (X1, Y1, X2, Y2, X3, Y3)
+					GLfloat axesSPC[6];
+					WBC_MAPPING.spcAxes(processedData, axesSPC);
 					
 					GLfloat maxAtr = 0.0;	// Initialize max attribute variable
 					// Check for max shift
@@ -2347,21 +3136,22 @@ void myDisplay()
 					glMatrixMode(GL_PROJECTION);
 					glLineWidth(4.0);	// Line width = 4.0
 					// Translate glyph based on value of first SPC x-coordinate
-					glTranslatef(-(1.0 - *(processedData.begin() + 3)), 0.0, 0.0);
+					glTranslatef(-(1.0 - axesSPC[0]), 0.0, 0.0);
 
 					float colors[6];
+					WBC_MAPPING.colors(processedData, colors);
 					// *********************** DRAW STICK FIGURE ***********************
-					glyph.drawGlyphSF(pos2, pos3, stickFig.begin(), *classVec, *turt, DYNAMIC_ANGLES, POS_ANGLE,
+					glyph.drawGlyphSF(&pos2, &pos3, stickFig, turt, DYNAMIC_ANGLES, POS_ANGLE,
 						GLYPH_SCALE_FACTOR, SF_SEGMENT_CONSTANT, SF_ANGLE_SCALE, ANGLE_FOCUS, BIRD_FOCUS, colors);
 
 					// RESET THE CP AND CD
-					turt->setCP(0.0, 0.0);
+					turt.setCP(0.0, 0.0);
 
 					// *********************** DRAW SPC AXES ***********************
 					if (DRAW_AXES)
 					{
 						glLineWidth(2.0);	// Line width = 2.0
-						glyph.drawAxesSPC(*pos2, *pos3, axesSPC.begin(),
+						glyph.drawAxesSPC(pos2, pos3, axesSPC,
 							AXIS_LENGTH, 0.25, DOTTED_AXES);
 					}
 
@@ -2406,15 +3196,15 @@ void myDisplay()
 		// Construct glyph tool
 		SpcSfGlyph glyph = SpcSfGlyph();
 		// Construct turtle tool
-		TurtleG* turt = new TurtleG();
-		Point2* pos2 = new Point2();
-		Point2* pos3 = new Point2();
+		TurtleG turt = TurtleG();
+		Point2 pos2 = Point2();
+		Point2 pos3 = Point2();
 
 		// Initialize data iterators
 		std::vector<std::vector<GLfloat>>::iterator repsIt = mostSimilarVectors.begin();
-		std::vector<bool>::iterator classIt = repsClass.begin();
+		std::vector<ClassLabel>::iterator classIt = repsClass.begin();
 		//std::vector<std::vector<GLfloat>>::iterator repsIt = mixedHood.begin();
-		//std::vector<bool>::iterator classIt = mixedClass.begin();
+		//std::vector<ClassLabel>::iterator classIt = mixedClass.begin();
 		std::vector<std::string>::iterator labelsIt = mostSimilarLabels.begin();
 		//std::vector<std::string>::iterator labelsIt = distanceLabels.begin();
 
@@ -2435,23 +3225,15 @@ void myDisplay()
 					glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
 					// Pointer to current data point
-					std::vector<GLfloat> processedData = *repsIt;
+					const std::vector<GLfloat>& processedData = *repsIt;
 					
-					std::vector<GLfloat> axesSPC{};
-					axesSPC.push_back(*(processedData.begin() + 3));	// X1
-					axesSPC.push_back(*(processedData.begin() + 2));	// Y1
-					axesSPC.push_back(*(processedData.begin() + 3));	// X2
-					axesSPC.push_back(*(processedData.begin() + 4));	// Y2
-					axesSPC.push_back(*(processedData.begin() + 8));	// X3
-					axesSPC.push_back(*(processedData.begin() + 7));	// Y3
+					// Encode SPC axes (X1, Y1, X2, Y2, X3, Y3)
+					GLfloat axesSPC[6];
+					WBC_MAPPING.spcAxes(processedData, axesSPC);
 
 					// Encode angles with most meaningful attributes
-					std::vector<GLfloat> stickFig{};
-					// Populate: CL (angle), UC (length), BN (angle), BC (length)
-					stickFig.push_back(*(processedData.begin()));			// Angle 1
-					stickFig.push_back(*(processedData.begin() + 1));	// Length 1
-					stickFig.push_back(*(processedData.begin() + 5));	// Angle 2
-					stickFig.push_back(*(processedData.begin() + 6));	// Length 2
+					GLfloat stickFig[4];
+					WBC_MAPPING.stickFigure(processedData, stickFig);
 
 					/*
 					// Vector holding Stick Figure attributes
@@ -2474,12 +3256,7 @@ void myDisplay()
 					*/
 
 					float colors[6];
-					colors[0] = *(processedData.begin() + 2);
-					colors[1] = *(processedData.begin() + 1);
-					colors[2] = *(processedData.begin() + 0);
-					colors[3] = *(processedData.begin() + 2);
-					colors[4] = *(processedData.begin() + 7);
-					colors[5] = *(processedData.begin() + 6);
+					WBC_MAPPING.colors(processedData, colors);
 
 					glViewport(		// (rowNum x colNum)
 						// Encode shift based off of first SPC axis horizontal/vertical shift.
@@ -2494,15 +3271,7 @@ void myDisplay()
 					glPushMatrix();
 					glMatrixMode(GL_MODELVIEW);
 					glLoadIdentity();
-					glColor3f(1.0, 0.0, 0.0);
-					if (*classIt)
-					{
-						glColor3f(0.0, 0.0, 1.0);
-					}
-					else
-					{
-						glColor3f(1.0, 0.0, 0.0);
-					}
+					setClassColor(*classIt, 1.0);
 					glRasterPos2f(-0.9, -0.9);
 	
 					//if (repCount < 0)
@@ -2518,7 +3287,7 @@ void myDisplay()
 						for (std::string::iterator labelIt = s.begin(); labelIt != s.end(); ++labelIt)
 						{	// Loop through string, displaying each character
 							char c = *labelIt;
-							glutBitmapCharacter(font, c);
+							if (!HEADLESS) glutBitmapCharacter(font, c);	// GLUT fonts need a GLUT window
 						}
 						//glEnable(GL_LIGHTING);
 						glPopMatrix();
@@ -2551,7 +3320,7 @@ void myDisplay()
 					//}
 					//else
 					//{	// Draw other glyphs in grey, if selected
-						glyph.drawGlyphSF(pos2, pos3, stickFig.begin(), *classIt, *turt, DYNAMIC_ANGLES, POS_ANGLE,
+						glyph.drawGlyphSF(&pos2, &pos3, stickFig, turt, DYNAMIC_ANGLES, POS_ANGLE,
 							GLYPH_SCALE_FACTOR, SF_SEGMENT_CONSTANT, SF_ANGLE_SCALE, ANGLE_FOCUS, BIRD_FOCUS, colors);
 					//}
 
@@ -2560,7 +3329,7 @@ void myDisplay()
 					glDisable(GL_BLEND);
 					++repCount;
 					// RESET THE CP AND CD
-					turt->setCP(0.0, 0.0);
+					turt.setCP(0.0, 0.0);
 
 					// *********************** DRAW SPC AXES ***********************
 					//if (DRAW_AXES)
@@ -2616,62 +3385,194 @@ void myDisplay()
 		glViewport(0.0, 0.0, SCREEN_WIDTH, SCREEN_HEIGHT);
 		gluOrtho2D(0.0, SCREEN_WIDTH, 0.0, SCREEN_HEIGHT);
 
-		GLfloat axisWidth = 4.0;
-		int numDimensions = 8;		// Num dimensions - 1
-		glColor3f(0.0, 0.0, 0.0);	// Black
-		glLineWidth(axisWidth);		// Axis width = 4
+		// Rows in the current neighborhood, or every row if DISPLAY_ALL is set
+		std::vector<bool> pcSelected(close);
+		if (DISPLAY_ALL) pcSelected.assign(allData.size(), true);
+		pcView.setRows(DataView(allData), classify.getLabels(), rowCounts.getWeights(), pcSelected, classify.numClasses());
+		pcView.setBins(PC_BINS);
 
-		// Draw PC axes
-		for (int i = 0; i <= numDimensions; i++)
+		// PC lines share the class colors of the glyphs: blue for benign, red for malignant
+		std::vector<GLfloat> pcPalette{};
+		for (ClassLabel label = 0; label < classify.numClasses(); ++label)
 		{
-			glBegin(GL_LINES);
-			glVertex2f(i * (SCREEN_WIDTH / numDimensions), 0.0);
-			glVertex2f(i * (SCREEN_WIDTH / numDimensions), SCREEN_HEIGHT);
-			glEnd();
+			const GLfloat* pcColor = classColor(label);
+			pcPalette.insert(pcPalette.end(), pcColor, pcColor + 3);
 		}
 
-		// Display current neighborhood
-		// Initialize data iterator
-		std::vector<std::vector<GLfloat>>::iterator it = allData.begin();
-		glColor3f(0.0, 1.0, 0.0);
-		GLfloat lineWidth = 2.0;
-		glLineWidth(lineWidth);		// Line width = 2
-
-		// Loop through data points
-		while (it != allData.end())
-		{	// If within current neighborhood
-			if (*threshold)
-			{
-				//Determine color by class
-				if (*classVec) glColor4f(0.0, 0.0, 0.8, 0.7);
-				else glColor4f(0.8, 0.0, 0.0, 0.7);
+		// Draw PC axes, axis width = 4
+		pcView.addAxes(&pcAxisBatch, SCREEN_WIDTH, SCREEN_HEIGHT, pcAxis);
+		glLineWidth(4.0);
+		pcAxisBatch.draw();
+		pcAxisBatch.clear();
+		glLineWidth(2.0);
 
-				// Draw PC graph of data point
-				glBegin(GL_LINE_STRIP);
-				for (int i = 0; i <= numDimensions; i++)
-				{
-					glVertex2f(i * (SCREEN_WIDTH / numDimensions), SCREEN_HEIGHT * (*it)[i]);
-				}
-				glEnd();
-			}
+		// Hyperblock bands under the rows
+		if (DISPLAY_HYPERCUBES)
+		{
+			batchHyperblockBands(hypercubeBlocks(), pcView, SCREEN_WIDTH, SCREEN_HEIGHT, pcPalette, 0.15, &envelopeBatch);
+			drawHyperblockEnvelopes();
+		}
 
-			++it;	// Increment iterators
-			++classVec;
-			++threshold;
+		if (PC_DENSITY)
+		{	// Draw the binned lines as one density image
+			pcDensity.resize(SCREEN_WIDTH, SCREEN_HEIGHT, classify.numClasses());
+			pcView.accumulateDensity(&pcDensity, SCREEN_WIDTH, SCREEN_HEIGHT);
+			std::vector<GLubyte> image{};
+			pcDensity.toneMap(DENSITY_EQUALIZED ? ToneMapping::Equalized : ToneMapping::Log, pcPalette, &image);
+			pcDensityTexture.upload(pcDensity.getWidth(), pcDensity.getHeight(), image);
+			pcDensityTexture.draw(SCREEN_WIDTH, SCREEN_HEIGHT);
+		}
+		else
+		{	// Draw PC graph of every selected row, line width = 2
+			pcView.addLines(&pcLineBatch, SCREEN_WIDTH, SCREEN_HEIGHT, pcPalette, 0.7);
+			pcLineBatch.draw();
+			pcLineBatch.clear();
 		}
+
 		glPopMatrix();
 	}
 
-	glutSwapBuffers();	// Swap buffers
+	if (!HEADLESS) glutSwapBuffers();	// Swap buffers
 	glFlush();			// Flush buffer
 }
 
+/*
+renderViews
+Draw views of a range of data points into an offscreen framebuffer
+of the window size and write each as <directory>/<view>_<index>.png,
+without a display server or a window. Labels drawn in GLUT bitmap
+fonts are left out of the images. The data is split with a fixed
+seed, and the SPC-SF view of index i shows the i-th testing point
+(wrapping around), so every image is the same from run to run.
+@param			view		spc, grid, reps, pc or all
+				directory	existing directory to write the images to
+				first, last	range of data indices to draw
+@return			0 if every image was written, 1 otherwise
+*/
+int renderViews(const std::string& view, const std::string& directory, unsigned int first, unsigned int last)
+{
+	const std::vector<std::string> views = { "spc", "grid", "reps", "pc" };
+	if (view != "all" && std::find(views.begin(), views.end(), view) == views.end())
+	{
+		std::cout << "Error: Unknown view " << view << ", expected spc, grid, reps, pc or all.\n";
+		std::cout << "Usage: --render [spc|grid|reps|pc|all] [directory] [first index] [last index]\n";
+		return 1;
+	}
+	std::cout << "Note: exported images have no text labels, which need a GLUT window.\n";
+
+	HeadlessContext context{};
+	if (!context.create(SCREEN_WIDTH, SCREEN_HEIGHT))
+	{
+		std::cout << "Error: No offscreen context, " << context.getError() << ".\n";
+		return 1;
+	}
+	HEADLESS = true;
+	myReshape(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+	// Fall back to drawing glyphs on the CPU if the context cannot run the glyph shaders
+	if (GPU_GLYPHS && !glyphRenderer.init())
+	{
+		std::cout << "Error: Glyph shaders unavailable, drawing glyphs without them.\n";
+	}
+
+	// Count the unique rows, which bound the data index, if no frame has yet
+	if (UNIQUE_DATA_SIZE == 0)
+	{
+		std::vector<std::vector<GLfloat>> allData(DATA_SIZE);
+		LabelColumn classify{};
+		importData(&allData, &classify);
+		deduplicateRows(&allData, &classify);
+		UNIQUE_DATA_SIZE = (unsigned int)allData.size();
+	}
+
+	last = std::min(last, UNIQUE_DATA_SIZE - 1);
+	if (first > last)
+	{
+		std::cout << "Error: Data index " << first << " is past the " << UNIQUE_DATA_SIZE << " unique rows.\n";
+		return 1;
+	}
+
+	int failed = 0;
+	for (unsigned int index = first; index <= last; ++index)
+	{
+		for (const std::string& name : views)
+		{
+			if (view != "all" && view != name) continue;
+
+			// Select the view as the keyboard toggles would
+			DISPLAY_SELECTOR = (name == "spc");
+			PC_OFF = (name != "pc");
+			REPS_OFF = (name != "reps");
+			DATA_INDEX = index;
+			myDisplay();
+
+			std::string path = directory + "/" + name + "_" + std::to_string(index) + ".png";
+			if (!PngWriter::write(path, SCREEN_WIDTH, SCREEN_HEIGHT, context.readPixels()))
+			{
+				std::cout << "Error: Could not write " << path << ".\n";
+				failed = 1;
+			}
+		}
+	}
+	HEADLESS = false;
+	return failed;
+}
+
 
 int main(int argc, char** argv)
 {
 	// Load parameters from config file
 	loadConfig();
 
+	// Print hyperblock overlap report instead of opening the visualization
+	if (argc > 1 && std::string(argv[1]) == "--hb-overlap")
+	{
+		reportHyperblockOverlaps();
+		return 0;
+	}
+
+	// Print points at risk of misclassification instead of opening the visualization
+	if (argc > 1 && std::string(argv[1]) == "--overlap-risk")
+	{
+		reportOverlapRisk();
+		return 0;
+	}
+
+	// Print the best glyph mapping for a data set instead of opening the visualization
+	if (argc > 1 && std::string(argv[1]) == "--optimize-mapping")
+	{
+		reportBestMapping((argc > 2) ? std::string(argv[2]) : "WBC");
+		return 0;
+	}
+
+	// Print the decision tree of a data set instead of opening the visualization
+	if (argc > 1 && std::string(argv[1]) == "--decision-tree")
+	{
+		reportDecisionTree((argc > 2) ? std::string(argv[2]) : "WBC");
+		return 0;
+	}
+
+	// Print clutter metrics of the located glyph layout instead of opening the visualization
+	if (argc > 1 && std::string(argv[1]) == "--clutter")
+	{
+		reportClutter();
+		return 0;
+	}
+
+	// Append new labelled rows to the hyperblock model
+	if (argc > 2 && std::string(argv[1]) == "--hb-append")
+	{
+		return updateHyperblockModel(argv[2]);
+	}
+
+	// Write views of data points as PNG images instead of opening the visualization
+	if (argc > 1 && std::string(argv[1]) == "--render")
+	{
+		unsigned int first = (argc > 4) ? (unsigned int)std::strtoul(argv[4], nullptr, 10) : DATA_INDEX;
+		unsigned int last = (argc > 5) ? (unsigned int)std::strtoul(argv[5], nullptr, 10) : first;
+		return renderViews((argc > 2) ? std::string(argv[2]) : "all", (argc > 3) ? std::string(argv[3]) : ".", first, last);
+	}
+
 	// Implement config struct
 	glutInit(&argc, argv);
 
@@ -2682,7 +3583,14 @@ int main(int argc, char** argv)
 	glutInitWindowPosition(100, 100);
 	glutCreateWindow("SPC-SF");
 
+	// Fall back to drawing glyphs on the CPU if the context cannot run the glyph shaders
+	if (GPU_GLYPHS && !glyphRenderer.init())
+	{
+		std::cout << "Error: Glyph shaders unavailable, drawing glyphs without them.\n";
+	}
+
 	glutDisplayFunc(myDisplay);
+	glutReshapeFunc(myReshape);
 	glutIdleFunc(myIdle);
 	glutKeyboardFunc(myKeyboard);
 	glutSpecialFunc(keyboard_special);
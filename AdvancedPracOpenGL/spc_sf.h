@@ -26,8 +26,11 @@ public:
 	// Constructor
 	SpcSfGlyph() {}
 
+	// Constructor: append glyph lines and axis lines to batches instead of drawing them immediately
+	SpcSfGlyph(VertexBatch* glyphLines, VertexBatch* axisLines) : glyphLines(glyphLines), axisLines(axisLines) {}
+
 	// Draw the three SPC coordinate pairs
-	void drawAxesSPC(Point2 pos2, Point2 pos3, std::vector<float>::iterator axes, GLfloat axisLength,
+	void drawAxesSPC(Point2 pos2, Point2 pos3, const GLfloat* axes, GLfloat axisLength,
 		GLfloat glyphScaleFactor, bool dottedAxes)
 	{
 		// Initialize scaling params
@@ -41,7 +44,7 @@ public:
 		float x5 = *++axes;// * GLYPH_SCALE_FACTOR;
 		float x6 = *++axes;// * GLYPH_SCALE_FACTOR;
 
-		if (dottedAxes)
+		if (dottedAxes && axisLines == nullptr)
 		{
 			// Enable line stipple
 			glPushAttrib(GL_ENABLE_BIT);
@@ -52,44 +55,37 @@ public:
 		}
 
 		// 1st pair: origin (0 - X1, 0 - X2)
-		glColor4f(COLOR_0, COLOR_1, COLOR_0, ALPHA_CROSS);	// Set color to light green
-		glBegin(GL_LINES);	// Draw first cross vertical
-		glVertex2f(-x1,
-			-x2 - (((axisLength * GLYPH_SCALE_FACTOR) + CROSS_SCALE) / CROSS_REDUCE) + CROSS_SCALE_FACTOR);
-		glVertex2f(-x1,
+		setColor(axisLines, COLOR_0, COLOR_1, COLOR_0, ALPHA_CROSS);	// Set color to light green
+		addLine(axisLines, -x1,	// Draw first cross vertical
+			-x2 - (((axisLength * GLYPH_SCALE_FACTOR) + CROSS_SCALE) / CROSS_REDUCE) + CROSS_SCALE_FACTOR,
+			-x1,
 			-x2 + (((axisLength * GLYPH_SCALE_FACTOR) + CROSS_SCALE) / CROSS_REDUCE) + CROSS_SCALE_FACTOR);
-		glEnd();	// end horizontal line
 
-		glBegin(GL_LINES);	// Draw first cross horizontal
-		glVertex2f(-x1 - (((axisLength * GLYPH_SCALE_FACTOR) + CROSS_SCALE) / CROSS_REDUCE) + CROSS_SCALE_FACTOR,
-			-x2);
-		glVertex2f(-x1 + (((axisLength * GLYPH_SCALE_FACTOR) + CROSS_SCALE) / CROSS_REDUCE) + CROSS_SCALE_FACTOR,
+		addLine(axisLines,	// Draw first cross horizontal
+			-x1 - (((axisLength * GLYPH_SCALE_FACTOR) + CROSS_SCALE) / CROSS_REDUCE) + CROSS_SCALE_FACTOR,
+			-x2,
+			-x1 + (((axisLength * GLYPH_SCALE_FACTOR) + CROSS_SCALE) / CROSS_REDUCE) + CROSS_SCALE_FACTOR,
 			-x2);
-		glEnd();	// end vertical line
 
 		// 2nd pair: origin ( )
-		glColor4f(0.0, 0.7, 0.0, 0.7);	// Set color to medium green
-		glBegin(GL_LINES);	// Draw second cross vertical
-		glVertex2f(pos2.getx() - x3, pos2.gety() - x4 - (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2)+ CROSS_SCALE_FACTOR);
-		glVertex2f(pos2.getx() - x3, pos2.gety() - x4 + (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2)+ CROSS_SCALE_FACTOR);
-		glEnd();
-		glBegin(GL_LINES);	// Draw second cross horizontal
-		glVertex2f(pos2.getx() - x3 - (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2)+ CROSS_SCALE_FACTOR, pos2.gety() - x4);
-		glVertex2f(pos2.getx() - x3 + (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2)+ CROSS_SCALE_FACTOR, pos2.gety() - x4);
-		glEnd();
+		setColor(axisLines, 0.0, 0.7, 0.0, 0.7);	// Set color to medium green
+		addLine(axisLines,	// Draw second cross vertical
+			pos2.getx() - x3, pos2.gety() - x4 - (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2)+ CROSS_SCALE_FACTOR,
+			pos2.getx() - x3, pos2.gety() - x4 + (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2)+ CROSS_SCALE_FACTOR);
+		addLine(axisLines,	// Draw second cross horizontal
+			pos2.getx() - x3 - (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2)+ CROSS_SCALE_FACTOR, pos2.gety() - x4,
+			pos2.getx() - x3 + (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2)+ CROSS_SCALE_FACTOR, pos2.gety() - x4);
 
 		// 3nd pair: origin ( )
-		glColor4f(0.0, 0.3, 0.0, 0.7);	// Set color to dark green
-		glBegin(GL_LINES);	// Draw third cross vertical
-		glVertex2f(pos3.getx() - x5, pos3.gety() - x6 - (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2) + CROSS_SCALE_FACTOR);
-		glVertex2f(pos3.getx() - x5, pos3.gety() - x6 + (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2) + CROSS_SCALE_FACTOR);
-		glEnd();
-		glBegin(GL_LINES);	// Draw third cross horizontal
-		glVertex2f(pos3.getx() - x5 - (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2) + CROSS_SCALE_FACTOR, pos3.gety() - x6);
-		glVertex2f(pos3.getx() - x5 + (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2) + CROSS_SCALE_FACTOR, pos3.gety() - x6);
-		glEnd();
-
-		if (dottedAxes)
+		setColor(axisLines, 0.0, 0.3, 0.0, 0.7);	// Set color to dark green
+		addLine(axisLines,	// Draw third cross vertical
+			pos3.getx() - x5, pos3.gety() - x6 - (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2) + CROSS_SCALE_FACTOR,
+			pos3.getx() - x5, pos3.gety() - x6 + (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2) + CROSS_SCALE_FACTOR);
+		addLine(axisLines,	// Draw third cross horizontal
+			pos3.getx() - x5 - (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2) + CROSS_SCALE_FACTOR, pos3.gety() - x6,
+			pos3.getx() - x5 + (((axisLength * GLYPH_SCALE_FACTOR) + 0.2) / 2) + CROSS_SCALE_FACTOR, pos3.gety() - x6);
+
+		if (dottedAxes && axisLines == nullptr)
 		{
 			glPopAttrib();
 		}
@@ -97,7 +93,7 @@ public:
 
 	// Draw 2-segment SF (Stick Figure) glyph
 	void drawGlyphSF(Point2* pos2, Point2* pos3,
-		std::vector<GLfloat>::iterator stick, bool benign, TurtleG turt, bool dynamicAngles, bool posAngle,
+		const GLfloat* stick, TurtleG turt, bool dynamicAngles, bool posAngle,
 		GLfloat glyphScaleFactor, GLfloat sfSegmentConstant, GLfloat sfAngleScale, bool ANGLE_FOCUS, bool birdFocus,
 		float colors[6] )
 	{
@@ -106,107 +102,128 @@ public:
 		SF_SEGMENT_CONSTANT = sfSegmentConstant;
 		SF_ANGLE_SCALE = sfAngleScale;
 
-		// Determine color by class
-		if (benign)
-		{	// If class is benign
-			if (birdFocus)
-			{	// If bird focus is on, color
-				glColor4f(colors[0], colors[1], colors[2], 1.0);
-			}
-			else
-			{	// If bird focus is off, grey out
-				glColor4f(0.0, 0.0, 0.0, 0.3);
-			}
-		}
-		else
-		{	// If class is malignant
-			if (birdFocus)
-			{	// If bird focus is on, color
-				glColor4f(colors[0], colors[1], colors[2], 1.0);
-			}
-			else
-			{	// If bird focus is off, grey out
-				glColor4f(0.0, 0.0, 0.0, 0.3);
-			}
-		}
+		// Trace both segments from the turtle's position, then draw them
+		RecordingTurtle recorder(turt.getCP().getx(), turt.getCP().gety(), turt.getCD());
+		traceGlyphSF(&recorder, stick, dynamicAngles, posAngle, ANGLE_FOCUS, pos2, pos3);
+		drawTracedGlyphSF(*pos2, *pos3, turt, birdFocus, colors);
+	}
 
+	/*
+	* drawTracedGlyphSF
+	* Draw the two segments of an SF glyph traced beforehand, from the
+	* turtle's position to pos2 and from pos2 to pos3.
+	*
+	* @param	pos2, pos3		end points of the first and second segments
+	*			turt			turtle drawing the segments
+	*			birdFocus		color the segments (true) or grey them out (false)
+	*			colors			colors of the first and second segments
+	*/
+	void drawTracedGlyphSF(Point2 pos2, Point2 pos3, TurtleG turt, bool birdFocus, const float colors[6])
+	{
+		// Append the stick figure to the glyph batch, if any
+		turt.setBatch(glyphLines);
+		Point2 origin = turt.getCP();
+
+		// First segment: colored if bird focus is on, greyed out if off (same for either class)
+		if (birdFocus) setColor(glyphLines, colors[0], colors[1], colors[2], 1.0);
+		else setColor(glyphLines, 0.0, 0.0, 0.0, 0.3);
+		turt.draw({ origin.getx(), origin.gety(), pos2.getx(), pos2.gety() });
+
+		//Determine color by class
+		//if (benign) glColor4f(0.0, 0.0, 0.8, 0.7);
+		//else glColor4f(0.8, 0.0, 0.0, 0.7);
+
+		// Second segment
+		if (birdFocus) setColor(glyphLines, colors[3], colors[4], colors[5], 0.7);
+		else setColor(glyphLines, 0.0, 0.0, 0.0, 0.3);
+		turt.draw({ pos2.getx(), pos2.gety(), pos3.getx(), pos3.gety() });
+	}
+
+	/*
+	* traceGlyphSF
+	* Move a recording turtle along the two segments of an SF glyph
+	* without drawing. Makes no GL calls, so glyphs can be traced in
+	* parallel.
+	*
+	* @param	turt			turtle recording the segments
+	*			stick			angle 1, length 1, angle 2, length 2
+	*			dynamicAngles	turn the second segment relative to the first
+	*			posAngle		turn the first segment up instead of down
+	*			angleFocus		encode angles (true) or lengths (false) with the first two attributes
+	*			pos2, pos3		end points of the first and second segments
+	*/
+	void traceGlyphSF(RecordingTurtle* turt, const GLfloat* stick, bool dynamicAngles, bool posAngle, bool angleFocus,
+		Point2* pos2, Point2* pos3)
+	{
 		GLfloat ang1 = 0;
 		GLfloat dist1 = 0;
 		GLfloat ang2 = 0;
 		GLfloat dist2 = 0;
-		if (ANGLE_FOCUS)
+		if (angleFocus)
 		{
 			ang1 = *stick;
 			dist1 = *(stick + 1);
 			ang2 = *(stick + 2);
 			dist2 = *(stick + 3);
 		}
-		else if (!ANGLE_FOCUS)
+		else
 		{
 			dist1 = *(stick + 2);
 			ang1 = *(stick + 3);
 			dist2 = *stick;
 			ang2 = *(stick + 1);
-
 		}
 
 		// First segment
 		if (posAngle)
 		{
-			turt.turnTo((normalizeAngle(ang1)));	// Positive angle
+			turt->turnTo((normalizeAngle(ang1)));	// Positive angle
 		}
 		else
 		{
-			turt.turnTo((-normalizeAngle(ang1)));	// Negative angle
+			turt->turnTo((-normalizeAngle(ang1)));	// Negative angle
 		}
 
-		turt.forward(dist1, true);
-		*pos2 = turt.getCP();
-
-		//Determine color by class
-		//if (benign) glColor4f(0.0, 0.0, 0.8, 0.7);
-		//else glColor4f(0.8, 0.0, 0.0, 0.7);
-
-		// Determine color by class
-		if (benign)
-		{
-			if (birdFocus)
-			{
-				glColor4f(colors[3], colors[4], colors[5], 0.7);
-			}
-			else
-			{
-				glColor4f(0.0, 0.0, 0.0, 0.3);
-			}
-		}
-		else
-		{
-			if (birdFocus)
-			{
-				glColor4f(colors[3], colors[4], colors[5], 0.7);
-			}
-			else
-			{
-				glColor4f(0.0, 0.0, 0.0, 0.3);
-			}
-		}
+		turt->forward(dist1, true);
+		*pos2 = turt->getCP();
 
 		//Second segment
 		if (dynamicAngles)
 		{
-			turt.turn(normalizeAngle(ang2));	// Dynamic angles
+			turt->turn(normalizeAngle(ang2));	// Dynamic angles
 		}
 		else 
 		{
-			turt.turnTo(normalizeAngle(ang2));	// Static angles
+			turt->turnTo(normalizeAngle(ang2));	// Static angles
 		}
 
-		turt.forward(dist2, true);
-		*pos3 = turt.getCP();
+		turt->forward(dist2, true);
+		*pos3 = turt->getCP();
 	}
 
 private:
 
+	// Set the current color of a batch, or the GL color when drawing immediately
+	void setColor(VertexBatch* batch, GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+	{
+		if (batch != nullptr) batch->setColor(r, g, b, a);
+		else glColor4f(r, g, b, a);
+	}
+
+	// Append a line to a batch, or draw it immediately
+	void addLine(VertexBatch* batch, GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1)
+	{
+		if (batch != nullptr)
+		{
+			batch->addLine(x0, y0, x1, y1);
+			return;
+		}
+		glBegin(GL_LINES);
+		glVertex2f(x0, y0);
+		glVertex2f(x1, y1);
+		glEnd();
+	}
+
 	// Normalize data value to angle value
 	GLfloat normalizeAngle(GLfloat m)
 	{
@@ -219,4 +236,7 @@ private:
 		// Normalization formula
 		return (((m - rmin) / (rmax - rmin)) * (tmax - tmin)) + tmin;
 	}
+
+	VertexBatch* glyphLines = nullptr;	// batch receiving stick figure lines (nullptr to draw immediately)
+	VertexBatch* axisLines = nullptr;	// batch receiving SPC cross lines (nullptr to draw immediately)
 };
\ No newline at end of file
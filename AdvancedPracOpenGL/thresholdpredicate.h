@@ -0,0 +1,102 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "GL/glut.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define THRESHOLD_PREDICATE_SSE 1
+#endif
+
+/* ThresholdPredicate: compiled per-attribute neighborhood test
+*  A row is in the neighborhood of a center point when every
+*  attribute is within that attribute's threshold of the center.
+*  compile() turns the center into lower and upper bounds once,
+*  so each test is a clamp-and-compare over the row:
+*  clamp(x, lower, upper) == x for every attribute. Four attributes
+*  are tested per step with SSE min/max when available.
+*/
+class ThresholdPredicate {
+public:
+	// Constructor
+	ThresholdPredicate() {}
+
+	/*
+	* ThresholdPredicate
+	* Constructor. Attributes past the end of the threshold
+	* vector use the default threshold.
+	*
+	* @param	thresholds			threshold of each attribute
+	*			defaultThreshold	threshold of remaining attributes
+	*/
+	ThresholdPredicate(const std::vector<GLfloat>& thresholds, GLfloat defaultThreshold)
+		: thresholds(thresholds), defaultThreshold(defaultThreshold) {}
+
+	/*
+	* compile
+	* Precompute the bounds of the neighborhood around a center point.
+	*
+	* @param	center	data point at the center of the neighborhood
+	*/
+	void compile(const std::vector<GLfloat>& center)
+	{
+		compile(center.data(), center.size());
+	}
+
+	// Precompute the bounds of the neighborhood around count attributes of a center point
+	void compile(const GLfloat* center, std::size_t count)
+	{
+		dimension = count;
+		lower.resize(dimension);
+		upper.resize(dimension);
+		for (std::size_t i = 0; i < dimension; ++i)
+		{
+			GLfloat threshold = (i < thresholds.size()) ? thresholds[i] : defaultThreshold;
+			lower[i] = center[i] - threshold;
+			upper[i] = center[i] + threshold;
+		}
+	}
+
+	// Test whether a row lies within the compiled neighborhood
+	bool operator()(const std::vector<GLfloat>& row) const
+	{
+		return contains(row.data(), std::min(dimension, row.size()));
+	}
+
+	// Test the first count attributes of a row against the compiled bounds
+	bool contains(const GLfloat* row, std::size_t count) const
+	{
+		std::size_t i = 0;
+		bool inside = true;
+
+#ifdef THRESHOLD_PREDICATE_SSE
+		int mask = 0xF;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(row + i);
+			__m128 clamped = _mm_min_ps(_mm_max_ps(x, _mm_loadu_ps(&lower[i])), _mm_loadu_ps(&upper[i]));
+			mask &= _mm_movemask_ps(_mm_cmpeq_ps(clamped, x));
+		}
+		inside = (mask == 0xF);
+#endif
+
+		for (; i < count; ++i)
+		{
+			inside &= (std::min(std::max(row[i], lower[i]), upper[i]) == row[i]);
+		}
+		return inside;
+	}
+
+	// Get the lower bounds of the compiled neighborhood
+	const std::vector<GLfloat>& getLower() const { return lower; }
+
+	// Get the upper bounds of the compiled neighborhood
+	const std::vector<GLfloat>& getUpper() const { return upper; }
+
+private:
+	std::vector<GLfloat> thresholds{};		// threshold of each attribute
+	GLfloat defaultThreshold = 0.0;			// threshold past the end of thresholds
+	std::size_t dimension = 0;				// attributes in compiled center
+	std::vector<GLfloat> lower{};			// lower bound of each attribute
+	std::vector<GLfloat> upper{};			// upper bound of each attribute
+};
@@ -1,52 +1,42 @@
 #pragma once
+#include <vector>
+#include <cmath>
 #include "point2.h"
 #include "GL/glut.h"
+#include "vertexbatch.h"
 
 // Constant value for converting radians to degrees
 const float RADIAN_PER_DEGREE = 0.017453393;
 
-/* TurtleG: Turtle Graphics drawing tool
-*  This object is used to perform line drawing
-*  operations using the "Turtle Graphics"
-*  concept, as described in the OpenGl Red Book.
-*  Chapter 3.
-* 
-*  This object draws lines based on initial and final
-*  position of the "turtle", and the currect angle
-*  (in degrees) the turtle is pointed torward.
-*
+// Line traced by a turtle, from (x0, y0) to (x1, y1)
+struct TurtleSegment {
+	GLfloat x0, y0;
+	GLfloat x1, y1;
+};
+
+/* RecordingTurtle: Turtle Graphics geometry without drawing
+*  Moves a "turtle" as described in the OpenGl Red Book,
+*  Chapter 3, but instead of drawing it appends each visible
+*  line to a caller-provided segment buffer. It makes no GL
+*  calls, so glyph geometry can be computed off the render
+*  thread, cached, or exported.
 */
-class TurtleG {
+class RecordingTurtle {
 public:
 	/*
-	* TurtleG
-	* Default constructor. Construct new
-	* TurtleG object with current position (CP)
-	* set to (0.0, 0.0).
-	*/
-	TurtleG()
-	{
-		this->CP = Point2(0.0, 0.0);
-		this->CD = 0.0;
-	}
-
-	/*
-	* TurtleG
-	* Constructor. Construct new TurtleG object
+	* RecordingTurtle
+	* Constructor. Construct new RecordingTurtle object
 	* with specified current position (CP) and
 	* current direction (CD).
-	* TurtleG object with current position (CP)
-	* set to (0.0, 0.0)
 	*
-	* @param	x		x coordinate of CP
-	*			y		y coordinate of CP
-	*			angle	initial direction of CD
+	* @param	x			x coordinate of CP
+	*			y			y coordinate of CP
+	*			angle		initial direction of CD
+	*			segments	buffer receiving visible lines, or nullptr to discard them
 	*/
-	TurtleG(GLfloat x, GLfloat y, GLfloat angle)
-	{
-		this->CP = Point2(x, y);
-		this->CD = angle;
-	}
+	RecordingTurtle(GLfloat x = 0.0, GLfloat y = 0.0, GLfloat angle = 0.0,
+		std::vector<TurtleSegment>* segments = nullptr)
+		: CP(x, y), CD(angle), segments(segments) {}
 
 	/*
 	* turnTo
@@ -74,19 +64,35 @@ public:
 	/*
 	* forward
 	* Move the turtle forward a given distance,
-	* drawing a line from start to finish.
+	* recording a line from start to finish.
 	*
 	* @param	distance	the distance to be traveled
-	*			isVisible	draw the line or not
+	*			isVisible	record the line or not
 	*/
 	void forward(float distance, bool isVisible)
 	{
-		// Determine endpoint based on radial distance
-		float x = CP.getx() + distance * cos(RADIAN_PER_DEGREE * CD);
-		float y = CP.gety() + distance * sin(RADIAN_PER_DEGREE * CD);
+		TurtleSegment segment = step(distance);
+		if (isVisible && segments != nullptr) segments->push_back(segment);
+	}
 
-		if (isVisible) lineTo(x, y);	// Move CP
-		else moveTo(x, y);
+	/*
+	* step
+	* Move the turtle forward a given distance.
+	*
+	* @param	distance	the distance to be traveled
+	* @return	TurtleSegment	line from the old to the new CP
+	*/
+	TurtleSegment step(float distance)
+	{
+		// Determine endpoint based on radial distance
+		TurtleSegment segment;
+		segment.x0 = CP.getx();
+		segment.y0 = CP.gety();
+		segment.x1 = segment.x0 + distance * cos(RADIAN_PER_DEGREE * CD);
+		segment.y1 = segment.y0 + distance * sin(RADIAN_PER_DEGREE * CD);
+
+		CP.set(segment.x1, segment.y1);	// Move CP
+		return segment;
 	}
 
 	/*
@@ -134,34 +140,18 @@ public:
 		return this->CD;
 	}
 
-private:
-
-	// Draw a line from CP to the new vertex
-	void lineTo(float x, float y)
-	{
-		glBegin(GL_LINES);
-		glVertex2f((GLfloat)CP.getx(), (GLfloat)CP.gety());
-		glVertex2f((GLfloat)x, (GLfloat)y);
-		glEnd();
-
-		CP.set(x, y);	// Update the CP
-		glFlush();		// Flush the buffer
-	}
-	void lineTo(Point2 p)
+	/*
+	* setSegments
+	* Set the buffer receiving visible lines.
+	*
+	* @param	buffer	buffer to append to, or nullptr to discard lines
+	*/
+	void setSegments(std::vector<TurtleSegment>* buffer)
 	{
-		glBegin(GL_LINES);
-		glVertex2f((GLfloat)CP.getx(), (GLfloat)CP.gety());
-		glVertex2f((GLfloat)p.getx(), (GLfloat)p.gety());
-		glEnd();
-
-		CP.set(p.getx(), p.gety());	// Update the CP
-		glFlush();		// Flush the buffer
+		this->segments = buffer;
 	}
 
-	// Update the CP
-	void moveTo(float x, float y) { CP.set(x, y); }
-
-	void moveTo(Point2 p) { CP.set(p.getx(), p.gety()); }
+protected:
 
 	// Current position
 	// (defines current location of turtle in viewport coordinates)
@@ -170,5 +160,95 @@ private:
 	// Current direction
 	// (defines current angle pointed in by turtle, from 0 to 360 degrees)
 	GLfloat CD = 0.0;
+
+private:
+
+	// Buffer receiving visible lines (nullptr to discard them)
+	std::vector<TurtleSegment>* segments = nullptr;
 };
 
+/* TurtleG: Turtle Graphics drawing tool
+*  This object is used to perform line drawing
+*  operations using the "Turtle Graphics"
+*  concept, as described in the OpenGl Red Book.
+*  Chapter 3.
+* 
+*  This object draws lines based on initial and final
+*  position of the "turtle", and the currect angle
+*  (in degrees) the turtle is pointed torward. The
+*  geometry comes from RecordingTurtle; this object
+*  only draws each line, immediately or into a batch.
+*
+*/
+class TurtleG : public RecordingTurtle {
+public:
+	/*
+	* TurtleG
+	* Default constructor. Construct new
+	* TurtleG object with current position (CP)
+	* set to (0.0, 0.0).
+	*/
+	TurtleG() {}
+
+	/*
+	* TurtleG
+	* Constructor. Construct new TurtleG object
+	* with specified current position (CP) and
+	* current direction (CD).
+	*
+	* @param	x		x coordinate of CP
+	*			y		y coordinate of CP
+	*			angle	initial direction of CD
+	*/
+	TurtleG(GLfloat x, GLfloat y, GLfloat angle) : RecordingTurtle(x, y, angle) {}
+
+	/*
+	* forward
+	* Move the turtle forward a given distance,
+	* drawing a line from start to finish.
+	*
+	* @param	distance	the distance to be traveled
+	*			isVisible	draw the line or not
+	*/
+	void forward(float distance, bool isVisible)
+	{
+		TurtleSegment segment = step(distance);
+		if (isVisible) draw(segment);
+	}
+
+	/*
+	* draw
+	* Draw a recorded line, immediately or into the batch.
+	*
+	* @param	segment		line to draw
+	*/
+	void draw(const TurtleSegment& segment)
+	{
+		if (batch != nullptr)
+		{
+			batch->addLine(segment.x0, segment.y0, segment.x1, segment.y1);
+			return;
+		}
+		glBegin(GL_LINES);
+		glVertex2f(segment.x0, segment.y0);
+		glVertex2f(segment.x1, segment.y1);
+		glEnd();
+	}
+
+	/*
+	* setBatch
+	* Append the lines drawn by the turtle to a batch
+	* instead of drawing them immediately.
+	*
+	* @param	lines	batch receiving the lines, or nullptr to draw immediately
+	*/
+	void setBatch(VertexBatch* lines)
+	{
+		this->batch = lines;
+	}
+
+private:
+
+	// Batch receiving drawn lines (nullptr to draw immediately)
+	VertexBatch* batch = nullptr;
+};
\ No newline at end of file
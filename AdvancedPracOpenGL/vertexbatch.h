@@ -0,0 +1,137 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "GL/glut.h"
+
+/* VertexBatch: per-frame buffer of colored primitives drawn in one call
+*  Primitives are appended with the color and viewport that would
+*  otherwise be set through glColor and glViewport, and are stored
+*  as interleaved window-space position and color. The whole buffer
+*  is drawn with a single glDrawArrays call from client-side vertex
+*  arrays, so the driver is called once per batch instead of once
+*  per line. Lines placed in a viewport are clipped to it, as the
+*  GL would clip them.
+*/
+class VertexBatch {
+public:
+	// Interleaved vertex: window position and RGBA color
+	struct Vertex {
+		GLfloat x, y;
+		GLfloat r, g, b, a;
+	};
+
+	/*
+	* VertexBatch
+	* Constructor.
+	*
+	* @param	mode	primitive type of the batch (GL_LINES or GL_TRIANGLES)
+	*/
+	VertexBatch(GLenum mode = GL_LINES) : mode(mode) {}
+
+	// Set the color of the following vertices
+	void setColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+	{
+		color[0] = r;
+		color[1] = g;
+		color[2] = b;
+		color[3] = a;
+	}
+
+	// Map the following vertices from normalized device coordinates into a window rectangle, as glViewport does
+	void setViewport(GLfloat x, GLfloat y, GLfloat width, GLfloat height)
+	{
+		scaleX = width / 2;
+		scaleY = height / 2;
+		offsetX = x + scaleX;
+		offsetY = y + scaleY;
+		clipped = true;
+	}
+
+	// Take the following vertices in window coordinates
+	void setWindow()
+	{
+		scaleX = 1.0;
+		scaleY = 1.0;
+		offsetX = 0.0;
+		offsetY = 0.0;
+		clipped = false;
+	}
+
+	// Append a vertex in the current viewport
+	void addVertex(GLfloat x, GLfloat y)
+	{
+		vertices.push_back({ offsetX + x * scaleX, offsetY + y * scaleY, color[0], color[1], color[2], color[3] });
+	}
+
+	// Append a line segment in the current viewport
+	void addLine(GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1)
+	{
+		if (clipped && !clipLine(&x0, &y0, &x1, &y1)) return;
+		addVertex(x0, y0);
+		addVertex(x1, y1);
+	}
+
+	/*
+	* draw
+	* Draw every vertex of the batch. The caller sets up a
+	* projection that maps window coordinates to the screen.
+	*/
+	void draw() const
+	{
+		if (vertices.empty()) return;
+
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].x);
+		glColorPointer(4, GL_FLOAT, sizeof(Vertex), &vertices[0].r);
+		glDrawArrays(mode, 0, (GLsizei)vertices.size());
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+	}
+
+	// Remove every vertex, keeping the allocated storage for the next frame
+	void clear() { vertices.clear(); }
+
+	// Number of vertices in the batch
+	std::size_t size() const { return vertices.size(); }
+
+private:
+
+	// Clip a segment to the [-1, 1] square of the viewport (Liang-Barsky), returning false if nothing is left
+	static bool clipLine(GLfloat* x0, GLfloat* y0, GLfloat* x1, GLfloat* y1)
+	{
+		GLfloat dx = *x1 - *x0;
+		GLfloat dy = *y1 - *y0;
+		GLfloat p[4] = { -dx, dx, -dy, dy };
+		GLfloat q[4] = { *x0 + 1, 1 - *x0, *y0 + 1, 1 - *y0 };
+		GLfloat enter = 0.0;
+		GLfloat leave = 1.0;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (p[i] == 0.0)
+			{
+				if (q[i] < 0.0) return false;	// parallel to and outside this edge
+				continue;
+			}
+			GLfloat t = q[i] / p[i];
+			if (p[i] < 0.0) enter = std::max(enter, t);
+			else leave = std::min(leave, t);
+		}
+		if (enter > leave) return false;
+
+		GLfloat startX = *x0;
+		GLfloat startY = *y0;
+		*x0 = startX + enter * dx;
+		*y0 = startY + enter * dy;
+		*x1 = startX + leave * dx;
+		*y1 = startY + leave * dy;
+		return true;
+	}
+
+	GLenum mode;									// primitive type
+	std::vector<Vertex> vertices{};					// interleaved vertices
+	GLfloat color[4] = { 0.0, 0.0, 0.0, 1.0 };		// color of the following vertices
+	GLfloat scaleX = 1.0, scaleY = 1.0;				// viewport scale
+	GLfloat offsetX = 0.0, offsetY = 0.0;			// viewport offset
+	bool clipped = false;							// clip lines to the viewport
+};